@@ -1,15 +1,7 @@
 #pragma once
 #include <cmath>
 #include <complex>
-#if __has_include(<numbers>)
-#include <numbers>
-namespace Numbers = std::numbers;
-#else
-namespace Numbers
-{
-inline constexpr double pi = 3.14159265358979323846264338327950218;
-}
-#endif
+#include "Numbers.h"
 
 namespace Complexs
 {
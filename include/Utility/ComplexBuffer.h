@@ -0,0 +1,406 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "Complex.h"
+#include "DataView.h"
+#include "Spectrum.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define UTILITY_COMPLEXBUFFER_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    define UTILITY_COMPLEXBUFFER_TARGET(isa)
+#  else
+#    define UTILITY_COMPLEXBUFFER_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#endif
+
+// 批量复数运算：实部、虚部分开存放 (SoA)，便于向量化
+namespace Complexs
+{
+// 实部与虚部分开的复数序列视图，第 i 个元素为 re[i·stride] + j·im[i·stride]
+// stride = 1 是 ComplexBuffer 的布局；stride = 2 可以直接套在 std::complex<double> 数组
+// （例如 FFT::output()）上，不需要复制
+template<typename T>
+struct SplitView
+{
+	Complex operator[](std::size_t i) const noexcept { return {re[i * stride], im[i * stride]}; }
+	bool contiguous() const noexcept { return stride == 1; }
+
+	template<typename U = T, std::enable_if_t<!std::is_const_v<U>, int> = 0>
+	operator SplitView<const U>() const noexcept { return {re, im, size, stride}; }
+
+	T* re;
+	T* im;
+	std::size_t size;
+	std::size_t stride = 1;
+};
+
+using CSplit = SplitView<const double>;
+using Split = SplitView<double>;
+
+inline CSplit interleaved(const std::complex<double>* data, std::size_t size) noexcept
+{
+	auto d = reinterpret_cast<const double*>(data);
+	return {d, d + 1, size, 2};
+}
+
+inline Split interleaved(std::complex<double>* data, std::size_t size) noexcept
+{
+	auto d = reinterpret_cast<double*>(data);
+	return {d, d + 1, size, 2};
+}
+
+// 实部、虚部各占一段 64 字节对齐的连续内存
+class ComplexBuffer
+{
+	static constexpr std::size_t alignment = 64;
+	struct Free
+	{
+		void operator()(double* p) const noexcept { ::operator delete[](p, std::align_val_t(alignment)); }
+	};
+
+public:
+	explicit ComplexBuffer(std::size_t size = 0) :
+		n(size),
+		// 虚部从下一个 64 字节边界开始
+		cap((size + 7) / 8 * 8),
+		data(static_cast<double*>(::operator new[](sizeof(double) * 2 * cap, std::align_val_t(alignment))))
+	{
+		std::fill(data.get(), data.get() + 2 * cap, 0.);
+	}
+
+	// 从任意布局复制，例如 ComplexBuffer(interleaved(fft.output(), fft.outSize()))
+	explicit ComplexBuffer(CSplit from) : ComplexBuffer(from.size)
+	{
+		for(std::size_t i = 0; i != n; ++i)
+		{
+			real().data[i] = from.re[i * from.stride];
+			imag().data[i] = from.im[i * from.stride];
+		}
+	}
+
+	ComplexBuffer(const ComplexBuffer& other) : ComplexBuffer(other.n)
+	{
+		if(cap != 0) std::memcpy(data.get(), other.data.get(), sizeof(double) * 2 * cap);
+	}
+
+	ComplexBuffer& operator=(const ComplexBuffer& other)
+	{
+		if(this != &other) *this = ComplexBuffer(other);
+		return *this;
+	}
+
+	// 移走后为空，size() 为 0
+	ComplexBuffer(ComplexBuffer&& other) noexcept :
+		n(std::exchange(other.n, 0)),
+		cap(std::exchange(other.cap, 0)),
+		data(std::move(other.data))
+	{}
+
+	ComplexBuffer& operator=(ComplexBuffer&& other) noexcept
+	{
+		if(this != &other)
+		{
+			n = std::exchange(other.n, 0);
+			cap = std::exchange(other.cap, 0);
+			data = std::move(other.data);
+		}
+		return *this;
+	}
+
+public:
+	std::size_t size() const noexcept { return n; }
+
+	DataViews::DataView<double> real() noexcept { return {data.get(), n}; }
+	DataViews::DataView<double> imag() noexcept { return {data.get() + cap, n}; }
+	DataViews::DataView<const double> real() const noexcept { return {data.get(), n}; }
+	DataViews::DataView<const double> imag() const noexcept { return {data.get() + cap, n}; }
+
+	Complex operator[](std::size_t i) const noexcept { return {data[i], data[cap + i]}; }
+	void set(std::size_t i, Complex c) noexcept { data[i] = c.real, data[cap + i] = c.imag(); }
+
+	Split view() noexcept { return {data.get(), data.get() + cap, n}; }
+	CSplit view() const noexcept { return {data.get(), data.get() + cap, n}; }
+	operator Split() noexcept { return view(); }
+	operator CSplit() const noexcept { return view(); }
+
+	// 写回交错存放的 std::complex 数组，例如 IFFT::buffer()
+	void store(Split dest) const
+	{
+		if(dest.size < n) throw std::logic_error("ComplexBuffer: output buffer is too small!");
+		for(std::size_t i = 0; i != n; ++i)
+		{
+			dest.re[i * dest.stride] = data[i];
+			dest.im[i * dest.stride] = data[cap + i];
+		}
+	}
+
+private:
+	std::size_t n;
+	std::size_t cap;
+	std::unique_ptr<double[], Free> data;
+};
+
+namespace Detail
+{
+inline void check(std::size_t in, std::size_t out)
+{
+	if(out < in) throw std::logic_error("Complexs: output buffer is too small!");
+}
+
+// 逐元素运算，全部连续时走指针循环，交给编译器向量化
+template<typename F>
+inline void each(std::size_t n, CSplit a, CSplit b, Split out, F&& f)
+{
+	if(a.contiguous() && b.contiguous() && out.contiguous())
+		for(std::size_t i = 0; i != n; ++i) f(a.re[i], a.im[i], b.re[i], b.im[i], out.re[i], out.im[i]);
+	else
+		for(std::size_t i = 0; i != n; ++i)
+			f(a.re[i * a.stride], a.im[i * a.stride], b.re[i * b.stride], b.im[i * b.stride],
+			  out.re[i * out.stride], out.im[i * out.stride]);
+}
+
+#if defined(UTILITY_COMPLEXBUFFER_X86)
+UTILITY_COMPLEXBUFFER_TARGET("avx2,fma")
+inline std::size_t mulAvx2(CSplit a, CSplit b, Split out) noexcept
+{
+	std::size_t i = 0;
+	for(; i + 4 <= a.size; i += 4)
+	{
+		__m256d ar = _mm256_loadu_pd(a.re + i), ai = _mm256_loadu_pd(a.im + i);
+		__m256d br = _mm256_loadu_pd(b.re + i), bi = _mm256_loadu_pd(b.im + i);
+		_mm256_storeu_pd(out.re + i, _mm256_fmsub_pd(ar, br, _mm256_mul_pd(ai, bi)));
+		_mm256_storeu_pd(out.im + i, _mm256_fmadd_pd(ar, bi, _mm256_mul_pd(ai, br)));
+	}
+	return i;
+}
+
+UTILITY_COMPLEXBUFFER_TARGET("avx2,fma")
+inline std::size_t absAvx2(CSplit a, double* out) noexcept
+{
+	std::size_t i = 0;
+	for(; i + 4 <= a.size; i += 4)
+	{
+		__m256d re = _mm256_loadu_pd(a.re + i), im = _mm256_loadu_pd(a.im + i);
+		_mm256_storeu_pd(out + i, _mm256_sqrt_pd(_mm256_fmadd_pd(re, re, _mm256_mul_pd(im, im))));
+	}
+	return i;
+}
+#endif
+
+inline bool useAvx2() noexcept
+{
+#if defined(UTILITY_COMPLEXBUFFER_X86)
+	return Spectrums::isa() != Spectrums::Isa::Scalar;
+#else
+	return false;
+#endif
+}
+} // namespace Detail
+
+// 以下运算的输出可以与输入是同一块内存（就地运算），输出至少与 a 一样长
+inline void add(CSplit a, CSplit b, Split out)
+{
+	Detail::check(a.size, std::min(b.size, out.size));
+	Detail::each(a.size, a, b, out, [](double ar, double ai, double br, double bi, double& r, double& i) {
+		r = ar + br, i = ai + bi;
+	});
+}
+
+inline void sub(CSplit a, CSplit b, Split out)
+{
+	Detail::check(a.size, std::min(b.size, out.size));
+	Detail::each(a.size, a, b, out, [](double ar, double ai, double br, double bi, double& r, double& i) {
+		r = ar - br, i = ai - bi;
+	});
+}
+
+inline void mul(CSplit a, CSplit b, Split out)
+{
+	Detail::check(a.size, std::min(b.size, out.size));
+	std::size_t done = 0;
+#if defined(UTILITY_COMPLEXBUFFER_X86)
+	if(a.contiguous() && b.contiguous() && out.contiguous() && Detail::useAvx2()) done = Detail::mulAvx2(a, b, out);
+#endif
+	auto rest = [&](auto v) { return decltype(v){v.re + done * v.stride, v.im + done * v.stride, v.size - done, v.stride}; };
+	Detail::each(a.size - done, rest(a), rest(b), rest(out),
+				 [](double ar, double ai, double br, double bi, double& r, double& i) {
+		const double re = ar * br - ai * bi;
+		i = ar * bi + ai * br, r = re;
+	});
+}
+
+inline void scale(CSplit a, double k, Split out)
+{
+	Detail::check(a.size, out.size);
+	Detail::each(a.size, a, a, out, [k](double ar, double ai, double, double, double& r, double& i) {
+		r = ar * k, i = ai * k;
+	});
+}
+
+inline void conj(CSplit a, Split out)
+{
+	Detail::check(a.size, out.size);
+	Detail::each(a.size, a, a, out, [](double ar, double ai, double, double, double& r, double& i) {
+		r = ar, i = -ai;
+	});
+}
+
+inline void abs(CSplit a, DataViews::DataView<double> out)
+{
+	Detail::check(a.size, out.size);
+	// 交错布局与 Spectrums 的输入相同
+	if(a.stride == 2 && a.im == a.re + 1)
+		return Spectrums::magnitude({reinterpret_cast<const std::complex<double>*>(a.re), a.size}, out);
+
+	std::size_t i = 0;
+#if defined(UTILITY_COMPLEXBUFFER_X86)
+	if(a.contiguous() && Detail::useAvx2()) i = Detail::absAvx2(a, out.data);
+#endif
+	for(; i != a.size; ++i) out.data[i] = Complex(a.re[i * a.stride], a.im[i * a.stride]).abs();
+}
+
+// 极坐标转换的精度
+// Exact：std::atan2 / cos / sin，与逐个构造 PolarComplex、转换回 Complex 的结果相同
+// Fast：多项式近似，没有函数调用和分支，便于向量化；
+//   辐角的绝对误差 < 5e-8 rad；|θ| < 1e6 时 cos / sin 的绝对误差 < 1e-12，
+//   超出该范围（以及 inf、nan）时改用 std::cos / std::sin
+//   模长始终是精确的
+enum class Accuracy { Exact, Fast };
+
+namespace Detail
+{
+inline double fastAtan2(double y, double x) noexcept
+{
+	constexpr double pi = 3.141592653589793, halfPi = pi / 2;
+	const double ax = std::abs(x), ay = std::abs(y);
+	const double hi = std::max(ax, ay), lo = std::min(ax, ay);
+	const double a = hi == 0 ? 0 : lo / hi, s = a * a;
+	// atan(a) 在 [0, 1] 上的最佳平方逼近，a·P(a²)
+	double p = -0.0040742453889338805;
+	for(double c : {0.02195012778870626, -0.056068460018854564, 0.0965666025580823, -0.13915967145518823,
+					0.1994854336500608, -0.3333010979501774, 0.9999994376236229})
+		p = p * s + c;
+	double r = p * a;
+	r = ay > ax ? halfPi - r : r;
+	r = std::signbit(x) ? pi - r : r;
+	return std::copysign(r, y);
+}
+
+inline void fastSinCos(double t, double& sin, double& cos) noexcept
+{
+	// 归约只在 |q| < 2^20 时精确，也保证了下面转换为 long long 不溢出
+	if(!(std::abs(t) < 1e6))
+	{
+		sin = std::sin(t), cos = std::cos(t);
+		return;
+	}
+	// θ = q·π/2 + x，|x| ≤ π/4
+	// Cody–Waite 归约：π/2 拆成三段，前两段只有 33 位有效数字，|q| < 2^20 时 q 与它们的乘积都是精确的
+	constexpr double twoOverPi = 0.6366197723675814;
+	constexpr double halfPi1 = 1.57079632673412561417e+00, halfPi2 = 6.07710050630396597660e-11,
+					 halfPi3 = 2.02226624871116645580e-21;
+	// 加减 1.5·2^52 舍入到整数，不调用 nearbyint（SSE2 下是函数调用）
+	constexpr double round = 6755399441055744.;
+	const double q = (t * twoOverPi + round) - round;
+	const double x = ((t - q * halfPi1) - q * halfPi2) - q * halfPi3, x2 = x * x;
+	// Taylor 展开到 x^13 / x^12，|x| ≤ π/4 时截断误差 < 1e-11
+	const double s = x * (1 + x2 * (-1. / 6 + x2 * (1. / 120 + x2 * (-1. / 5040 + x2 * (1. / 362880 + x2 * (-1. / 39916800 + x2 / 6227020800.))))));
+	const double c = 1 + x2 * (-1. / 2 + x2 * (1. / 24 + x2 * (-1. / 720 + x2 * (1. / 40320 + x2 * (-1. / 3628800 + x2 / 479001600.)))));
+	const auto quadrant = static_cast<long long>(q) & 3;
+	sin = quadrant == 0 ? s : quadrant == 1 ? c : quadrant == 2 ? -s : -c;
+	cos = quadrant == 0 ? c : quadrant == 1 ? -s : quadrant == 2 ? -c : s;
+}
+
+// r、theta 的相邻元素间隔 stride 个 double；精度作为模板参数，循环内没有分支
+template<Accuracy accuracy>
+inline void polar(CSplit a, double* r, double* theta, std::size_t stride) noexcept
+{
+	for(std::size_t i = 0; i != a.size; ++i)
+	{
+		const double re = a.re[i * a.stride], im = a.im[i * a.stride];
+		r[i * stride] = std::sqrt(re * re + im * im);
+		if constexpr(accuracy == Accuracy::Exact)
+			theta[i * stride] = std::atan2(im, re);
+		else
+			theta[i * stride] = fastAtan2(im, re);
+	}
+}
+
+template<Accuracy accuracy>
+inline void cartesian(const double* r, const double* theta, std::size_t stride, Split out) noexcept
+{
+	for(std::size_t i = 0; i != out.size; ++i)
+	{
+		double s, c;
+		if constexpr(accuracy == Accuracy::Exact)
+			s = std::sin(theta[i * stride]), c = std::cos(theta[i * stride]);
+		else
+			fastSinCos(theta[i * stride], s, c);
+		out.re[i * out.stride] = r[i * stride] * c;
+		out.im[i * out.stride] = r[i * stride] * s;
+	}
+}
+
+static_assert(sizeof(Complex) == 2 * sizeof(double) && sizeof(PolarComplex) == 2 * sizeof(double));
+} // namespace Detail
+
+// 模与辐角，辐角在 [-π, π]
+inline void toPolar(CSplit a, DataViews::DataView<double> r, DataViews::DataView<double> theta,
+					Accuracy accuracy = Accuracy::Exact)
+{
+	Detail::check(a.size, std::min(r.size, theta.size));
+	abs(a, r);
+	if(accuracy == Accuracy::Exact)
+		for(std::size_t i = 0; i != a.size; ++i) theta.data[i] = std::atan2(a.im[i * a.stride], a.re[i * a.stride]);
+	else
+		for(std::size_t i = 0; i != a.size; ++i) theta.data[i] = Detail::fastAtan2(a.im[i * a.stride], a.re[i * a.stride]);
+}
+
+inline void fromPolar(DataViews::DataView<const double> r, DataViews::DataView<const double> theta, Split out,
+					  Accuracy accuracy = Accuracy::Exact)
+{
+	Detail::check(r.size, std::min(theta.size, out.size));
+	out.size = r.size;
+	if(accuracy == Accuracy::Exact)
+		Detail::cartesian<Accuracy::Exact>(r.data, theta.data, 1, out);
+	else
+		Detail::cartesian<Accuracy::Fast>(r.data, theta.data, 1, out);
+}
+
+// Complex 与 PolarComplex 数组之间的批量转换
+inline void toPolar(DataViews::DataView<const Complex> in, DataViews::DataView<PolarComplex> out,
+					Accuracy accuracy = Accuracy::Exact)
+{
+	Detail::check(in.size, out.size);
+	if(in.size == 0) return;
+	const CSplit from{&in.data->real, &in.data->imag.value, in.size, 2};
+	if(accuracy == Accuracy::Exact)
+		Detail::polar<Accuracy::Exact>(from, &out.data->r, &out.data->theta, 2);
+	else
+		Detail::polar<Accuracy::Fast>(from, &out.data->r, &out.data->theta, 2);
+}
+
+inline void toComplex(DataViews::DataView<const PolarComplex> in, DataViews::DataView<Complex> out,
+					  Accuracy accuracy = Accuracy::Exact)
+{
+	Detail::check(in.size, out.size);
+	if(in.size == 0) return;
+	const Split to{&out.data->real, &out.data->imag.value, in.size, 2};
+	if(accuracy == Accuracy::Exact)
+		Detail::cartesian<Accuracy::Exact>(&in.data->r, &in.data->theta, 2, to);
+	else
+		Detail::cartesian<Accuracy::Fast>(&in.data->r, &in.data->theta, 2, to);
+}
+} // namespace Complexs
+
+#undef UTILITY_COMPLEXBUFFER_TARGET
+#undef UTILITY_COMPLEXBUFFER_X86
@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <Utility/LinkedMap.h>
+
+// 读多写少、多线程共享的 LinkMap
+// 读者取得当前版本的快照（不可变的 LinkMap）后随意查找、遍历 list() / map()；
+// 写者之间用互斥锁排队，每次修改复制一份当前版本，改完再发布（copy-on-write），并递增版本号
+// 每个线程缓存最近取得的快照：版本号没变时 get / contains / size 只读一次版本号，不加锁也不改引用计数；
+// 版本变化后第一次读取才重新取快照，这一步用 shared_ptr 的原子操作，标准库可能在内部加锁
+// 缓存按 ConcurrentLinkMap 的类型每线程一份，同一线程交替读同类型的多个对象时每次切换都要重新取；
+// 缓存会让旧快照多存活到该线程下一次读取或退出
+// 每次写入 O(n)，连续多次修改应放在一次 update 中完成
+template<typename K, typename V, typename A = std::allocator<std::pair<const K, V>>>
+class ConcurrentLinkMap
+{
+public:
+	using Map = LinkMap<K, V, A>;
+	using Snapshot = std::shared_ptr<const Map>;
+
+	ConcurrentLinkMap() : current(std::make_shared<const Map>()), id(nextId()) {}
+	explicit ConcurrentLinkMap(Map map) : current(std::make_shared<const Map>(std::move(map))), id(nextId()) {}
+
+	ConcurrentLinkMap(const ConcurrentLinkMap&) = delete;
+	ConcurrentLinkMap& operator=(const ConcurrentLinkMap&) = delete;
+
+public: // 读者
+	// 返回的快照持有一份引用计数，遍历期间不会被释放
+	Snapshot snapshot() const noexcept { return cached(); }
+
+	template<typename Key>
+	std::optional<V> get(const Key& k) const
+	{
+		if(auto v = cached()->tryGet(k)) return *v;
+		return std::nullopt;
+	}
+
+	template<typename Key>
+	bool contains(const Key& k) const { return cached()->contains(k); }
+
+	std::size_t size() const noexcept { return cached()->size(); }
+
+public: // 写者
+	// f(Map&) 修改一份副本，按值返回 f 的返回值（引用会被复制，不会指向已发布的快照）；f 抛出异常时不发布
+	template<typename F>
+	std::decay_t<std::invoke_result_t<F&, Map&>> update(F&& f)
+	{
+		std::lock_guard lock(mutex);
+		auto next = std::make_shared<Map>(*load());
+		if constexpr(std::is_void_v<std::invoke_result_t<F&, Map&>>)
+		{
+			f(*next);
+			store(std::move(next));
+		}
+		else
+		{
+			std::decay_t<std::invoke_result_t<F&, Map&>> result = f(*next);
+			store(std::move(next));
+			return result;
+		}
+	}
+
+	template<typename Key, typename... Vs>
+	bool insert(Key&& k, Vs&&... vs)
+	{
+		return update([&](Map& m) { return m.insert(std::forward<Key>(k), std::forward<Vs>(vs)...).second; });
+	}
+
+	template<typename Key, typename... Vs>
+	bool emplace(Key&& k, Vs&&... vs)
+	{
+		return update([&](Map& m) { return m.emplace(std::forward<Key>(k), std::forward<Vs>(vs)...).second; });
+	}
+
+	template<typename Key>
+	bool erase(const Key& k)
+	{
+		std::lock_guard lock(mutex);
+		auto old = load();
+		if(!old->contains(k)) return false;
+		auto next = std::make_shared<Map>(*old);
+		K key(k);
+		next->erase(key);
+		store(std::move(next));
+		return true;
+	}
+
+	// 不复制旧版本
+	void clear()
+	{
+		std::lock_guard lock(mutex);
+		store(std::make_shared<const Map>());
+	}
+
+private:
+	struct Cache
+	{
+		std::uint64_t owner = 0;
+		std::uint64_t version = 0;
+		Snapshot snapshot;
+	};
+
+	// 先读版本号再取快照：取到的快照不会比该版本旧，偏新时下次读取再取一次
+	const Snapshot& cached() const noexcept
+	{
+		thread_local Cache cache;
+		const auto v = version.load(std::memory_order_acquire);
+		if(cache.owner != id || cache.version != v)
+		{
+			cache.snapshot = load();
+			cache.owner = id;
+			cache.version = v;
+		}
+		return cache.snapshot;
+	}
+
+	// 先发布快照再递增版本号
+	void store(Snapshot s) noexcept
+	{
+		publish(std::move(s));
+		version.fetch_add(1, std::memory_order_release);
+	}
+
+	// 对象的编号从 1 开始，与未使用的缓存区分，也避免把已析构对象的缓存当成新对象的
+	static std::uint64_t nextId() noexcept
+	{
+		static std::atomic<std::uint64_t> last = 0;
+		return ++last;
+	}
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+	Snapshot load() const noexcept { return current.load(std::memory_order_acquire); }
+	void publish(Snapshot s) noexcept { current.store(std::move(s), std::memory_order_release); }
+
+	std::atomic<Snapshot> current;
+#else
+	Snapshot load() const noexcept { return std::atomic_load_explicit(&current, std::memory_order_acquire); }
+	void publish(Snapshot s) noexcept { std::atomic_store_explicit(&current, std::move(s), std::memory_order_release); }
+
+	Snapshot current;
+#endif
+	std::atomic<std::uint64_t> version = 0;
+	const std::uint64_t id;
+	std::mutex mutex;
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "FFT.h"
+
+// 基于 FFT 的快速线性卷积与互相关，复杂度 O(N log M)
+// 滤波器的频谱在构造时计算一次，之后可对任意多段信号重复使用
+namespace Convolutions
+{
+using CView = DataViews::DataView<const double>;
+using View = DataViews::DataView<double>;
+
+namespace Detail
+{
+inline std::size_t fftSize(std::size_t M)
+{
+	// 块长约为滤波器长度的 3 倍时，每个输出点的运算量接近最小
+	std::size_t N = 64;
+	while(N < 4 * M) N *= 2;
+	return N;
+}
+
+class Filter
+{
+public:
+	Filter(CView h, FFTRigor rigor) :
+		M(std::max<std::size_t>(h.size, 1)),
+		fft(fftSize(M), rigor),
+		ifft(fft.size(), rigor),
+		H(fft.outSize())
+	{
+		auto in = fft.buffer();
+		std::fill(std::copy(h.begin(), h.end(), in.begin()), in.end(), 0.);
+		fft.calc();
+		// 归一化并入滤波器频谱，逆变换后无需再除以 N
+		const double scale = 1. / double(fft.size());
+		std::transform(fft.output(), fft.output() + H.size(), H.begin(),
+					   [=](const auto& c) noexcept { return c * scale; });
+	}
+
+	std::size_t size() const noexcept { return M; }
+	std::size_t outSize(std::size_t inSize) const noexcept { return inSize == 0 ? 0 : inSize + M - 1; }
+
+protected:
+	// fft.buffer() 已填好一段输入，结果在 ifft.output()
+	const double* circular()
+	{
+		fft.calc();
+		std::transform(fft.output(), fft.output() + H.size(), H.begin(), ifft.buffer().begin(),
+					   std::multiplies<>{});
+		ifft.calc();
+		return ifft.output();
+	}
+
+	void check(CView x, View y) const
+	{
+		if(y.size < outSize(x.size)) throw std::logic_error("Convolutions: output buffer is too small!");
+	}
+
+protected:
+	const std::size_t M;
+	FFT fft;
+	IFFT ifft;
+	std::vector<std::complex<double>> H;
+};
+} // namespace Detail
+
+// 重叠相加：输入按 L = N - M + 1 分块，每块补零变换，结果叠加到输出
+class OverlapAdd : public Detail::Filter
+{
+public:
+	OverlapAdd(CView h, FFTRigor rigor = FFTRigor::Estimate) : Filter(h, rigor) {}
+
+	// 完整线性卷积，y 至少有 outSize(x.size) 个点
+	void convolve(CView x, View y)
+	{
+		check(x, y);
+		const auto N = fft.size(), L = N - M + 1, total = outSize(x.size);
+		std::fill(y.begin(), y.begin() + total, 0.);
+		auto in = fft.buffer();
+		for(std::size_t pos = 0; pos < x.size; pos += L)
+		{
+			auto count = std::min(L, x.size - pos);
+			std::fill(std::copy(x.begin() + pos, x.begin() + pos + count, in.begin()), in.end(), 0.);
+			auto out = circular();
+			auto valid = std::min(N, total - pos);
+			std::transform(out, out + valid, y.begin() + pos, y.begin() + pos, std::plus<>{});
+		}
+	}
+
+	std::vector<double> convolve(CView x)
+	{
+		std::vector<double> y(outSize(x.size));
+		convolve(x, y);
+		return y;
+	}
+};
+
+// 重叠保留：每次变换 N 个相邻输入点，丢弃受循环卷积回绕影响的前 M - 1 个结果
+class OverlapSave : public Detail::Filter
+{
+public:
+	OverlapSave(CView h, FFTRigor rigor = FFTRigor::Estimate) : Filter(h, rigor) {}
+
+	// 完整线性卷积，y 至少有 outSize(x.size) 个点
+	void convolve(CView x, View y)
+	{
+		check(x, y);
+		const auto N = fft.size(), L = N - M + 1, total = outSize(x.size);
+		auto in = fft.buffer();
+		// 输入前后各视为补了 M - 1 个零，第 j 个点对应 x[j - (M - 1)]
+		for(std::size_t pos = 0; pos < total; pos += L)
+		{
+			auto lo = std::max(pos, M - 1), hi = std::min(pos + N, M - 1 + x.size);
+			std::fill(in.begin(), in.end(), 0.);
+			if(lo < hi) std::copy(x.begin() + (lo - (M - 1)), x.begin() + (hi - (M - 1)), in.begin() + (lo - pos));
+			auto out = circular();
+			auto count = std::min(L, total - pos);
+			std::copy(out + M - 1, out + M - 1 + count, y.begin() + pos);
+		}
+	}
+
+	std::vector<double> convolve(CView x)
+	{
+		std::vector<double> y(outSize(x.size));
+		convolve(x, y);
+		return y;
+	}
+};
+
+inline std::vector<double> convolve(CView x, CView h)
+{
+	return OverlapAdd(h).convolve(x);
+}
+
+// 互相关 r[k] = Σ x[n + k]·y[n]，结果的第 i 个点对应 k = i - (y.size - 1)
+inline std::vector<double> correlate(CView x, CView y)
+{
+	std::vector<double> reversed(y.begin(), y.end());
+	std::reverse(reversed.begin(), reversed.end());
+	return OverlapAdd(reversed).convolve(x);
+}
+} // namespace Convolutions
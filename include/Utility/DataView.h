@@ -84,7 +84,7 @@ class DataView : public DB<T>
 	using MT = std::remove_const_t<T>;
 	using CT = std::add_const_t<T>;
 public:
-	using typename Base::type;
+	using type = typename Base::type;
 	using Base::Base;
 
 	constexpr operator DataView<CT>() const noexcept { return {data, size}; }
@@ -1,59 +1,301 @@
 #pragma once
 #include <execution> // std::execution::par_unseq
-#include <algorithm> // std::transform
+#include <algorithm> // std::copy
+#include <filesystem>
+#include <stdexcept>
+#include <mutex>
+#include <map>
+#include <memory>
+#include <new>
+#include <tuple>
 #include <complex> // Need to be included before <fftw3.h>!
 #include <fftw3.h>
+#include "DataView.h"
+#include "Spectrum.h"
 
-class FFT
+// 变换种类：实数正变换、实数逆变换、复数正/逆变换
+enum class FFTKind : int { R2C, C2R, Forward, Backward };
+
+// 规划越严格，构造越慢、执行越快；Measure 以上应配合 BasicFFTPlans::loadWisdom 使用，
+// 避免每次启动都重新测量
+enum class FFTRigor : unsigned
+{
+	Estimate   = FFTW_ESTIMATE,
+	Measure    = FFTW_MEASURE,
+	Patient    = FFTW_PATIENT,
+	Exhaustive = FFTW_EXHAUSTIVE,
+};
+
+// fftw / fftwf / fftwl 三套 API 按标量类型分派
+// init() 必须先于该精度的其他 fftw 调用，进程内只真正执行一次
+template<typename T> struct FFTApi;
+
+#if defined(UTILITY_FFT_THREADS)
+#  define UTILITY_FFT_API_THREADS(X)                                         \
+	static void init()                                                       \
+	{                                                                        \
+		[[maybe_unused]] static const int inited = X##init_threads();        \
+	}                                                                        \
+	static constexpr auto planWithThreads = X##plan_with_nthreads;
+#else
+#  define UTILITY_FFT_API_THREADS(X) \
+	static void init() noexcept {}
+#endif
+
+#define UTILITY_FFT_API(T, X)                                                   \
+template<>                                                                      \
+struct FFTApi<T>                                                                \
+{                                                                               \
+	using Plan = X##plan;                                                       \
+	using Complex = X##complex;                                                 \
+	static constexpr auto malloc = X##malloc;                                   \
+	static constexpr auto free = X##free;                                       \
+	static constexpr auto planR2C = X##plan_many_dft_r2c;                       \
+	static constexpr auto planC2R = X##plan_many_dft_c2r;                       \
+	static constexpr auto planC2C = X##plan_many_dft;                           \
+	static constexpr auto executeR2C = X##execute_dft_r2c;                      \
+	static constexpr auto executeC2R = X##execute_dft_c2r;                      \
+	static constexpr auto executeC2C = X##execute_dft;                          \
+	static constexpr auto destroy = X##destroy_plan;                            \
+	static constexpr auto exportWisdom = X##export_wisdom_to_filename;          \
+	static constexpr auto importWisdom = X##import_wisdom_from_filename;        \
+	UTILITY_FFT_API_THREADS(X)                                                  \
+};
+
+UTILITY_FFT_API(float, fftwf_)
+UTILITY_FFT_API(double, fftw_)
+UTILITY_FFT_API(long double, fftwl_)
+
+#undef UTILITY_FFT_API
+#undef UTILITY_FFT_API_THREADS
+
+// 进程内共享的 plan 缓存，按 (变换种类, 点数, 通道数, flags, 线程数) 索引，每种精度各一份
+// 同样参数的 FFT 只规划一次；fftw 的规划器不是线程安全的，所有规划都在锁内完成
+template<typename T>
+class BasicFFTPlans
 {
-	using Complex = std::complex<double>;
+	using Api = FFTApi<T>;
 public:
-	FFT(std::size_t N) :
-		N(N),
-		in(fftw_malloc(sizeof(double) * N)),
-		out(fftw_malloc(sizeof(Complex) * (N / 2 + 1))),
-		p(fftw_plan_dft_r2c_1d(int(N),
-							   static_cast<double*>(in),
-							   static_cast<fftw_complex*>(out),
-							   FFTW_ESTIMATE))
-	{}
+	using Plan = typename Api::Plan;
+	using Key = std::tuple<FFTKind, std::size_t, std::size_t, unsigned, int>;
+
+	template<typename Make>
+	static Plan get(const Key& key, Make&& make)
+	{
+		Api::init();
+		auto& self = instance();
+		std::lock_guard lock(self.mutex);
+		auto pos = self.plans.find(key);
+		if(pos != self.plans.end()) return pos->second;
+
+#if defined(UTILITY_FFT_THREADS)
+		Api::planWithThreads(std::get<4>(key));
+#endif
+		auto p = make(std::get<3>(key));
+		if(!p) throw std::runtime_error("fftw can't create the plan");
+		self.plans.emplace(key, p);
+		return p;
+	}
+
+	// wisdom 记录了已测量过的规划，加载后 Measure 等规划几乎不再耗时
+	static bool saveWisdom(const std::filesystem::path& file)
+	{
+		Api::init();
+		std::lock_guard lock(instance().mutex);
+		return Api::exportWisdom(file.string().c_str()) != 0;
+	}
 
-	~FFT()
+	static bool loadWisdom(const std::filesystem::path& file)
 	{
-		fftw_destroy_plan(p);
-		fftw_free(out);
-		fftw_free(in);
+		Api::init();
+		std::lock_guard lock(instance().mutex);
+		return Api::importWisdom(file.string().c_str()) != 0;
 	}
 
+private:
+	BasicFFTPlans() = default;
+	~BasicFFTPlans() { for(auto& [key, p] : plans) Api::destroy(p); }
+
+	static BasicFFTPlans& instance()
+	{
+		static BasicFFTPlans plans;
+		return plans;
+	}
+
+private:
+	std::mutex mutex;
+	std::map<Key, Plan> plans;
+};
+
+using FFTPlans = BasicFFTPlans<double>;
+using FFTPlansf = BasicFFTPlans<float>;
+using FFTPlansl = BasicFFTPlans<long double>;
+
+// 一次变换 howMany 个通道，每个通道 N 个点，在 input() / output() 中连续存放
+// 定义 UTILITY_FFT_THREADS 并链接 fftw3_threads 后，threads 参数才生效
+// 规划交给 FFTPlans，同样参数的变换共享一个 plan
+// 实数变换的频域每个通道只有 N / 2 + 1 个点；逆变换不做归一化，结果是原信号的 N 倍
+// 注意：C2R 的 calc 会覆盖输入缓冲区
+// T 为 float / double / long double，分别对应 fftwf / fftw / fftwl
+template<FFTKind kind, typename T = double>
+class BasicFFT
+{
+	using Api = FFTApi<T>;
+	using Plans = BasicFFTPlans<T>;
+	using Complex = std::complex<T>;
+	static constexpr bool realIn = kind == FFTKind::R2C;
+	static constexpr bool realOut = kind == FFTKind::C2R;
+public:
+	using In = std::conditional_t<realIn, T, Complex>;
+	using Out = std::conditional_t<realOut, T, Complex>;
+
+	BasicFFT(std::size_t N, FFTRigor rigor = FFTRigor::Estimate) : BasicFFT(N, 1, 1, rigor) {}
+
+	BasicFFT(std::size_t N, std::size_t howMany, int threads = 1,
+			 FFTRigor rigor = FFTRigor::Estimate) :
+		N(N),
+		howMany(howMany),
+		in(allocate(sizeof(In) * inSize() * howMany)),
+		out(allocate(sizeof(Out) * outSize() * howMany)),
+		p(plan(threads, rigor))
+	{}
+
+	BasicFFT(const BasicFFT&) = delete;
+	BasicFFT& operator=(const BasicFFT&) = delete;
+
 public:
-	const double* input() const noexcept { return static_cast<double*>(in); }
-	const Complex* output() const noexcept { return static_cast<Complex*>(out); }
-    std::size_t size() const noexcept { return N; }
+	const In* input() const noexcept { return static_cast<In*>(in.get()); }
+	const Out* output() const noexcept { return static_cast<Out*>(out.get()); }
+	std::size_t size() const noexcept { return N; }
 
-	const FFT& calc(const double* input) noexcept
+	std::size_t channels() const noexcept { return howMany; }
+	std::size_t inSize() const noexcept { return realOut ? N / 2 + 1 : N; }
+	std::size_t outSize() const noexcept { return realIn ? N / 2 + 1 : N; }
+
+	const In* input(std::size_t channel) const noexcept { return input() + channel * inSize(); }
+	const Out* output(std::size_t channel) const noexcept { return output() + channel * outSize(); }
+
+	// 直接写入对齐的输入缓冲区，写完后调用 calc()，省去 calc(input) 的复制
+	DataViews::DataView<In> buffer() noexcept { return {inData(), inSize() * howMany}; }
+	DataViews::DataView<In> buffer(std::size_t channel) noexcept { return {inData() + channel * inSize(), inSize()}; }
+
+	const BasicFFT& calc() noexcept
 	{
-		std::copy(std::execution::par_unseq, input, input + N, this->input());
-		fftw_execute(p);
+		if constexpr(kind == FFTKind::R2C)
+			Api::executeR2C(p, inData(), complexOut());
+		else if constexpr(kind == FFTKind::C2R)
+			Api::executeC2R(p, complexIn(), outData());
+		else
+			Api::executeC2C(p, complexIn(), complexOut());
 		return *this;
 	}
 
+	// input 包含全部通道，即 inSize() * channels() 个点
+	const BasicFFT& calc(const In* input) noexcept
+	{
+		std::copy(std::execution::par_unseq, input, input + inSize() * howMany, inData());
+		return calc();
+	}
+
+	// 全部通道的幅值，按通道依次存放；C2R 的输出是实数，没有 abs
 	template<template<typename...> typename Vec>
-	Vec<double> abs() const noexcept
+	Vec<T> abs() const noexcept
 	{
-        const int outSize = int(N / 2 + 1);
-		Vec<double> vec(outSize);
-		auto o = this->output();
-		std::transform(std::execution::par_unseq, o, o + outSize,
-					   vec.data(), [](const auto& d) noexcept { return std::abs(d); });
-		return vec;
+		static_assert(!realOut, "abs() needs a complex output");
+		return absOf<Vec>(output(), outSize() * howMany);
+	}
+
+	template<template<typename...> typename Vec>
+	Vec<T> abs(std::size_t channel) const noexcept
+	{
+		static_assert(!realOut, "abs() needs a complex output");
+		return absOf<Vec>(output(channel), outSize());
+	}
+
+	// 幅值写入调用者提供的缓冲区，不分配内存
+	void abs(DataViews::DataView<T> dest) const
+	{
+		static_assert(!realOut, "abs() needs a complex output");
+		absTo(output(), outSize() * howMany, dest);
+	}
+
+	void abs(std::size_t channel, DataViews::DataView<T> dest) const
+	{
+		static_assert(!realOut, "abs() needs a complex output");
+		absTo(output(channel), outSize(), dest);
 	}
 
 private:
-	double* input() noexcept { return static_cast<double*>(in); }
+	// fftw_malloc 的内存用 fftw_free 释放；plan 抛出异常时已分配的缓冲区也会释放
+	using Buffer = std::unique_ptr<void, void (*)(void*)>;
+
+	static Buffer allocate(std::size_t bytes)
+	{
+		Api::init();
+		Buffer buffer(Api::malloc(bytes), Api::free);
+		if(!buffer && bytes != 0) throw std::bad_alloc();
+		return buffer;
+	}
+
+	In* inData() noexcept { return static_cast<In*>(in.get()); }
+	Out* outData() noexcept { return static_cast<Out*>(out.get()); }
+	auto complexIn() noexcept { return static_cast<typename Api::Complex*>(in.get()); }
+	auto complexOut() noexcept { return static_cast<typename Api::Complex*>(out.get()); }
+
+	template<template<typename...> typename Vec>
+	static Vec<T> absOf(const Complex* o, std::size_t count) noexcept
+	{
+		Vec<T> vec(count);
+		Spectrums::magnitude<T>({o, count}, {vec.data(), count});
+		return vec;
+	}
+
+	static void absTo(const Complex* o, std::size_t count, DataViews::DataView<T> dest)
+	{
+		if(dest.size < count) throw std::logic_error("FFT: output buffer is too small!");
+		Spectrums::magnitude<T>({o, count}, dest);
+	}
+
+	// 缓存的 plan 用 fftw_execute_dft_* 作用于本对象的缓冲区，
+	// fftw_malloc 保证了对齐方式与规划时一致
+	typename Plans::Plan plan(int threads, FFTRigor rigor)
+	{
+		const int n = int(N), ni = int(inSize()), no = int(outSize()), many = int(howMany);
+		auto key = typename Plans::Key{kind, N, howMany, unsigned(rigor), threads};
+		return Plans::get(key, [&](unsigned flags) {
+			if constexpr(kind == FFTKind::R2C)
+				return Api::planR2C(1, &n, many, inData(), nullptr, 1, ni,
+									complexOut(), nullptr, 1, no, flags);
+			else if constexpr(kind == FFTKind::C2R)
+				return Api::planC2R(1, &n, many, complexIn(), nullptr, 1, ni,
+									outData(), nullptr, 1, no, flags);
+			else
+				return Api::planC2C(1, &n, many, complexIn(), nullptr, 1, ni,
+									complexOut(), nullptr, 1, no,
+									kind == FFTKind::Forward ? FFTW_FORWARD : FFTW_BACKWARD,
+									flags);
+		});
+	}
 
 private:
 	const std::size_t N;
-	void* in;
-	void* out;
-	fftw_plan p;
+	const std::size_t howMany;
+	Buffer in;
+	Buffer out;
+	typename Plans::Plan p; // 由 FFTPlans 持有
 };
+
+using FFT = BasicFFT<FFTKind::R2C>;
+using IFFT = BasicFFT<FFTKind::C2R>;
+using ComplexFFT = BasicFFT<FFTKind::Forward>;
+using ComplexIFFT = BasicFFT<FFTKind::Backward>;
+
+using FFTf = BasicFFT<FFTKind::R2C, float>;
+using IFFTf = BasicFFT<FFTKind::C2R, float>;
+using ComplexFFTf = BasicFFT<FFTKind::Forward, float>;
+using ComplexIFFTf = BasicFFT<FFTKind::Backward, float>;
+
+using FFTl = BasicFFT<FFTKind::R2C, long double>;
+using IFFTl = BasicFFT<FFTKind::C2R, long double>;
+using ComplexFFTl = BasicFFT<FFTKind::Forward, long double>;
+using ComplexIFFTl = BasicFFT<FFTKind::Backward, long double>;
@@ -0,0 +1,350 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// FlatLinkMap 默认的哈希，对字符串是透明的，可以用 std::string_view、const char* 查找而不构造临时的 K
+template<typename K>
+struct FlatLinkHash : std::hash<K> {};
+
+// 与 std::hash<std::string> 的结果相同
+template<typename C, typename A>
+struct FlatLinkHash<std::basic_string<C, std::char_traits<C>, A>>
+{
+	using is_transparent = void;
+	std::size_t operator()(std::basic_string_view<C> s) const noexcept { return std::hash<std::basic_string_view<C>>{}(s); }
+};
+
+// 与 LinkMap 相同的双顺序 Map：list() 按插入顺序，map() 按 Key 值
+// 值按插入顺序连续存放在数组里，用开放寻址（线性探测）的哈希表按 Key 查找下标：
+// 查找、插入、删除均摊 O(1)，遍历只是顺序扫描数组
+// 与 LinkMap 的区别：
+// - 遍历得到 std::pair<const K&, V&>，用 auto [k, v] 或 auto&& [k, v] 解构
+// - map() 每次调用都要排序一遍，O(n log n)，只适合偶尔按 Key 遍历
+// - 删除只留下空洞，空洞超过一半时整体压缩；插入与删除都可能使引用和遍历器失效
+// - 槽位最多 2^32 个，因此最多约 3·2^30 个元素
+template<typename K, typename V, typename Hash = FlatLinkHash<K>, typename Eq = std::equal_to<>>
+class FlatLinkMap
+{
+	using Item = std::optional<std::pair<K, V>>;
+
+	// index 为 items 中的下标；tag 为混合后哈希值的高 32 位，同时决定理想的槽位
+	struct Slot
+	{
+		std::uint32_t index;
+		std::uint32_t tag;
+	};
+	static constexpr std::uint32_t empty = ~std::uint32_t(0);
+
+	template<bool isConst> class ListIterBase;
+	template<bool isConst> class MapViewBase;
+
+public:
+	using ListIter = ListIterBase<false>;
+	using ListConstIter = ListIterBase<true>;
+	using MapView = MapViewBase<false>;
+	using MapConstView = MapViewBase<true>;
+
+	FlatLinkMap() = default;
+	FlatLinkMap(std::initializer_list<std::pair<K, V>> values)
+	{
+		reserve(values.size());
+		for(auto&& [key, value] : values) emplace(key, value);
+	}
+
+public:
+	using InsertResult = std::pair<V&, bool>;
+	template<typename Key, typename... Vs> InsertResult insert(Key&& k, Vs&&... vs)  // init
+	{
+		return add(std::forward<Key>(k), [&] { return V{std::forward<Vs>(vs)...}; });
+	}
+	template<typename Key, typename... Vs> InsertResult emplace(Key&& k, Vs&&... vs) // ctor
+	{
+		return add(std::forward<Key>(k), [&] { return V(std::forward<Vs>(vs)...); });
+	}
+
+	// 可能触发压缩，移动 V 时的异常会传出
+	template<typename Key>
+	bool erase(const Key& k)
+	{
+		auto pos = find(k);
+		if(pos == empty) return false;
+		items[slots[pos].index].reset();
+		unlink(pos);
+		--count;
+		if(holes() > count) compact();
+		return true;
+	}
+
+	void clear() noexcept
+	{
+		items.clear();
+		std::fill(slots.begin(), slots.end(), Slot{empty, 0});
+		count = 0;
+	}
+
+	void reserve(std::size_t n)
+	{
+		items.reserve(n);
+		if(n * 4 > slots.size() * 3) rehash(n);
+	}
+
+	template<typename Key>
+	bool contains(const Key& k) const noexcept { return find(k) != empty; }
+
+	std::size_t size() const noexcept { return count; }
+
+	template<typename Key> V& at(const Key& k)
+	{
+		if(auto v = tryGet(k)) return *v;
+		throw std::out_of_range("FlatLinkMap: key not found!");
+	}
+
+	template<typename Key> const V& at(const Key& k) const
+	{
+		return const_cast<FlatLinkMap&>(*this).at(k);
+	}
+
+	template<typename Key> V* tryGet(const Key& k) noexcept
+	{
+		auto pos = find(k);
+		return pos == empty ? nullptr : &items[slots[pos].index]->second;
+	}
+
+	template<typename Key> const V* tryGet(const Key& k) const noexcept
+	{
+		return const_cast<FlatLinkMap&>(*this).tryGet(k);
+	}
+
+	// 插入顺序中的位置；没有空洞时 O(1)，否则要数一遍前面的空洞
+	template<typename Key> std::size_t indexOf(const Key& k) const
+	{
+		auto pos = find(k);
+		if(pos == empty) throw std::out_of_range("FlatLinkMap: key not found!");
+		auto i = slots[pos].index;
+		if(holes() == 0) return i;
+		return std::size_t(std::count_if(items.begin(), items.begin() + i, [](const Item& item) { return item.has_value(); }));
+	}
+
+public:
+	ListIter list() & { return {items.data(), items.data() + items.size()}; }
+	ListConstIter list() const& { return {items.data(), items.data() + items.size()}; }
+	MapView map() & { return MapView(*this); }
+	MapConstView map() const& { return MapConstView(*this); }
+
+private:
+	std::size_t holes() const noexcept { return items.size() - count; }
+
+	static std::uint32_t tagOf(std::size_t h) noexcept
+	{
+		// std::hash 对整数是恒等映射，乘以黄金分割数后取高位，使低位的差别也能扩散到槽位上
+		return std::uint32_t((std::uint64_t(h) * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+
+	std::size_t home(std::uint32_t tag) const noexcept { return tag >> (32 - bits); }
+	std::size_t mask() const noexcept { return slots.size() - 1; }
+
+	template<typename Key>
+	std::size_t find(const Key& k) const noexcept
+	{
+		if(count == 0) return empty;
+		const auto tag = tagOf(Hash{}(k));
+		for(auto pos = home(tag);; pos = (pos + 1) & mask())
+		{
+			const auto& s = slots[pos];
+			if(s.index == empty) return empty;
+			if(s.tag == tag && Eq{}(items[s.index]->first, k)) return pos;
+		}
+	}
+
+	template<typename Key, typename Make>
+	InsertResult add(Key&& k, Make&& make)
+	{
+		if(auto pos = find(k); pos != empty) return {items[slots[pos].index]->second, false};
+		if((count + 1) * 4 > slots.size() * 3) rehash(count + 1);
+
+		// 空洞与元素合计超过 uint32 能表示的下标时先压缩
+		if(items.size() >= empty) compact();
+		auto& item = items.emplace_back(std::in_place, K(std::forward<Key>(k)), make());
+		place(items.size() - 1);
+		++count;
+		return {item->second, true};
+	}
+
+	// 删除槽位后把后面同一段探测序列中的元素往前挪，不留墓碑
+	void unlink(std::size_t i) noexcept
+	{
+		for(auto j = (i + 1) & mask(); slots[j].index != empty; j = (j + 1) & mask())
+		{
+			if(((j - home(slots[j].tag)) & mask()) >= ((j - i) & mask()))
+			{
+				slots[i] = slots[j];
+				i = j;
+			}
+		}
+		slots[i] = {empty, 0};
+	}
+
+	// 把 items[i] 放进第一个空槽位
+	void place(std::size_t i)
+	{
+		const auto tag = tagOf(Hash{}(items[i]->first));
+		auto pos = home(tag);
+		while(slots[pos].index != empty) pos = (pos + 1) & mask();
+		slots[pos] = {std::uint32_t(i), tag};
+	}
+
+	// 槽位数为 2 的幂，负载不超过 3/4；tag 只有 32 位，槽位最多 2^32 个
+	void rehash(std::size_t n)
+	{
+		unsigned need = 4;
+		while((std::size_t(1) << need) * 3 < n * 4) ++need;
+		if(need > 32) throw std::length_error("FlatLinkMap: too many elements!");
+		bits = need;
+		slots.assign(std::size_t(1) << bits, Slot{empty, 0});
+		for(std::size_t i = 0; i != items.size(); ++i)
+			if(items[i]) place(i);
+	}
+
+	// 去掉空洞，保持插入顺序；槽位表大小不变，原地重新填写，不分配内存
+	void compact()
+	{
+		std::size_t to = 0;
+		for(std::size_t from = 0; from != items.size(); ++from)
+		{
+			if(!items[from]) continue;
+			if(to != from) items[to] = std::move(items[from]);
+			++to;
+		}
+		items.resize(to);
+		std::fill(slots.begin(), slots.end(), Slot{empty, 0});
+		for(std::size_t i = 0; i != items.size(); ++i) place(i);
+	}
+
+private:
+	std::vector<Item> items;
+	std::vector<Slot> slots;
+	std::size_t count = 0;
+	unsigned bits = 0;
+};
+
+template<typename K, typename V, typename Hash, typename Eq>
+template<bool isConst>
+class FlatLinkMap<K, V, Hash, Eq>::ListIterBase
+{
+	friend FlatLinkMap;
+	using ItemPtr = std::conditional_t<isConst, const Item*, Item*>;
+	using Value = std::conditional_t<isConst, const V, V>;
+
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::pair<const K&, Value&>;
+	using difference_type = std::ptrdiff_t;
+	using reference = value_type;
+
+	struct pointer
+	{
+		value_type pair;
+		const value_type* operator->() const noexcept { return &pair; }
+	};
+
+private:
+	ListIterBase(ItemPtr pos, ItemPtr last) noexcept : pos(pos), last(last) { skip(); }
+
+public:
+	ListIterBase& operator++() noexcept { ++pos; skip(); return *this; }
+	ListIterBase operator++(int) noexcept { auto temp = *this; ++*this; return temp; }
+
+	reference operator*() const noexcept { return {(*pos)->first, (*pos)->second}; }
+	pointer operator->() const noexcept { return {**this}; }
+
+	explicit operator bool() const noexcept { return pos != last; }
+
+	bool operator==(const ListIterBase& r) const noexcept { return pos == r.pos; }
+	bool operator!=(const ListIterBase& r) const noexcept { return pos != r.pos; }
+
+	ListIterBase begin() const noexcept { return *this; }
+	ListIterBase end() const noexcept { return {last, last}; }
+
+	const K& key() const noexcept { return (*pos)->first; }
+	Value& value() const noexcept { return (*pos)->second; }
+
+private:
+	void skip() noexcept { while(pos != last && !*pos) ++pos; }
+
+private:
+	ItemPtr pos;
+	ItemPtr last;
+};
+
+// 构造时按 Key 排好序的一组下标
+template<typename K, typename V, typename Hash, typename Eq>
+template<bool isConst>
+class FlatLinkMap<K, V, Hash, Eq>::MapViewBase
+{
+	friend FlatLinkMap;
+	using Owner = std::conditional_t<isConst, const FlatLinkMap, FlatLinkMap>;
+	using Value = std::conditional_t<isConst, const V, V>;
+	using Order = std::vector<std::uint32_t>;
+
+	explicit MapViewBase(Owner& owner) : owner(&owner)
+	{
+		order.reserve(owner.count);
+		for(std::size_t i = 0; i != owner.items.size(); ++i)
+			if(owner.items[i]) order.push_back(std::uint32_t(i));
+		std::sort(order.begin(), order.end(), [&](auto a, auto b) {
+			return std::less<>{}(owner.items[a]->first, owner.items[b]->first);
+		});
+	}
+
+public:
+	class Iter
+	{
+		friend MapViewBase;
+		Iter(Owner* owner, typename Order::const_iterator pos) noexcept : owner(owner), pos(pos) {}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<const K&, Value&>;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type;
+
+		struct pointer
+		{
+			value_type pair;
+			const value_type* operator->() const noexcept { return &pair; }
+		};
+
+		Iter& operator++() noexcept { ++pos; return *this; }
+		Iter operator++(int) noexcept { auto temp = *this; ++pos; return temp; }
+
+		reference operator*() const noexcept
+		{
+			auto& item = owner->items[*pos];
+			return {item->first, item->second};
+		}
+
+		pointer operator->() const noexcept { return {**this}; }
+
+		bool operator==(const Iter& r) const noexcept { return pos == r.pos; }
+		bool operator!=(const Iter& r) const noexcept { return pos != r.pos; }
+
+	private:
+		Owner* owner;
+		typename Order::const_iterator pos;
+	};
+
+	Iter begin() const noexcept { return {owner, order.begin()}; }
+	Iter end() const noexcept { return {owner, order.end()}; }
+	std::size_t size() const noexcept { return order.size(); }
+
+private:
+	Owner* owner;
+	Order order;
+};
@@ -1,5 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <stdexcept>
 #include <Utility/ObjectAddress.h>
 #include <Utility/Macros.h>
@@ -75,8 +82,20 @@ private:
     V v;
 };
 
-template<typename V>
-class ListNode : private StorageWrapper<V>, public ListNodeBase
+// 插入顺序的位置索引（隐式 treap）的节点部分，只有 IndexedLinkMap 的节点带有
+struct RankNode
+{
+	RankNode* left = nullptr;
+	RankNode* right = nullptr;
+	RankNode* parent = nullptr;
+	std::size_t size = 1;       // 子树的节点数
+	std::uint32_t priority = 0; // 堆序，父节点不小于子节点
+};
+
+struct NoRank {};
+
+template<typename V, bool ranked = false>
+class ListNode : private StorageWrapper<V>, public ListNodeBase, public std::conditional_t<ranked, RankNode, NoRank>
 {
     using Value = StorageWrapper<V>;
 public:
@@ -92,16 +111,181 @@ public:
     using Value::value;
 };
 
+// 插入顺序的位置索引：中序与链表顺序一致的 treap，按子树大小定位，优先级随机
+// 在任意位置插入、删除、求位置、按位置查找都是期望 O(log n)；每次修改后立即有效，查询不修改任何状态
+// 节点的内存由调用者管理，RankTree 只串起节点里的指针
+class RankTree
+{
+public:
+	RankTree() noexcept = default;
+	RankTree(RankTree&& r) noexcept : root(std::exchange(r.root, nullptr)), seed(r.seed) {}
+	RankTree& operator=(RankTree&& r) noexcept
+	{
+		root = std::exchange(r.root, nullptr);
+		seed = r.seed;
+		return *this;
+	}
+
+	// node 插到 before 之前，before 为 nullptr 时插到末尾
+	void insert(RankNode* node, const RankNode* before) noexcept
+	{
+		node->left = node->right = node->parent = nullptr;
+		node->size = 1;
+		node->priority = next();
+		if(!before)
+			root = merge(root, node);
+		else
+		{
+			RankNode *l, *r;
+			split(root, rank(before), l, r);
+			root = merge(merge(l, node), r);
+		}
+		root->parent = nullptr;
+	}
+
+	void remove(RankNode* node) noexcept
+	{
+		auto parent = node->parent;
+		auto child = merge(node->left, node->right);
+		if(child) child->parent = parent;
+		if(!parent) root = child;
+		else if(parent->left == node) parent->left = child;
+		else parent->right = child;
+		for(; parent; parent = parent->parent) --parent->size;
+	}
+
+	std::size_t rank(const RankNode* node) const noexcept
+	{
+		auto i = sizeOf(node->left);
+		for(; node->parent; node = node->parent)
+			if(node == node->parent->right) i += sizeOf(node->parent->left) + 1;
+		return i;
+	}
+
+	// i 必须小于元素个数
+	RankNode* at(std::size_t i) const noexcept
+	{
+		auto node = root;
+		for(;;)
+		{
+			const auto left = sizeOf(node->left);
+			if(i == left) return node;
+			if(i < left)
+				node = node->left;
+			else
+			{
+				i -= left + 1;
+				node = node->right;
+			}
+		}
+	}
+
+	void clear() noexcept { root = nullptr; }
+
+private:
+	static std::size_t sizeOf(const RankNode* node) noexcept { return node ? node->size : 0; }
+
+	static void pull(RankNode* node) noexcept
+	{
+		node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+		if(node->left) node->left->parent = node;
+		if(node->right) node->right->parent = node;
+	}
+
+	// 前 k 个节点分到 l，其余分到 r；递归深度为树高，期望 O(log n)
+	static void split(RankNode* node, std::size_t k, RankNode*& l, RankNode*& r) noexcept
+	{
+		if(!node)
+		{
+			l = r = nullptr;
+			return;
+		}
+		if(sizeOf(node->left) < k)
+		{
+			split(node->right, k - sizeOf(node->left) - 1, node->right, r);
+			l = node;
+		}
+		else
+		{
+			split(node->left, k, l, node->left);
+			r = node;
+		}
+		pull(node);
+	}
+
+	// a 中的节点都排在 b 之前
+	static RankNode* merge(RankNode* a, RankNode* b) noexcept
+	{
+		if(!a) return b;
+		if(!b) return a;
+		if(a->priority > b->priority)
+		{
+			a->right = merge(a->right, b);
+			pull(a);
+			return a;
+		}
+		b->left = merge(a, b->left);
+		pull(b);
+		return b;
+	}
+
+	// xorshift32
+	std::uint32_t next() noexcept
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+
+private:
+	RankNode* root = nullptr;
+	std::uint32_t seed = 0x9E3779B9u;
+};
+
+// LinkMap 节点的内存池：按大块向上游申请，逐个分配，release() 或析构时整体释放
+using LinkMapArena = std::pmr::monotonic_buffer_resource;
+
+// 从 LinkMapArena 分配、从不回收的分配器，deallocate 什么也不做
+// erase 掉的节点直到 arena.release() 才归还，适合整批构建、整批丢弃的场景
+template<typename T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+
+	ArenaAllocator(LinkMapArena& arena) noexcept : arena(&arena) {}
+	template<typename U> ArenaAllocator(const ArenaAllocator<U>& r) noexcept : arena(r.resource()) {}
+
+	T* allocate(std::size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T*, std::size_t) noexcept {}
+
+	LinkMapArena* resource() const noexcept { return arena; }
+
+	template<typename U> bool operator==(const ArenaAllocator<U>& r) const noexcept { return arena == r.resource(); }
+	template<typename U> bool operator!=(const ArenaAllocator<U>& r) const noexcept { return arena != r.resource(); }
+
+private:
+	LinkMapArena* arena;
+};
+
+template<typename A> inline constexpr bool isArenaAllocator = false;
+template<typename T> inline constexpr bool isArenaAllocator<ArenaAllocator<T>> = true;
+
 // 既可按插入顺序遍历，也可按 Key 值遍历的 Map
 // 注意：如果不需要按 Key 值遍历，应该用 std::vector<std::pair<K, V>>!!!
-template<typename K, typename V>
+// 按位置访问（listAt、indexOf、index()、emplaceAt 等）默认沿链表 O(n)；
+// indexed 为 true（即 IndexedLinkMap）时每个节点多带一个 RankTree 节点，约 40 字节，
+// 插入、删除、moveBack 多花 O(log n)，按位置访问降为 O(log n)
+// 所有 const 操作都不修改内部状态，多个线程可以同时读同一个 LinkMap
+template<typename K, typename V, typename A = std::allocator<std::pair<const K, V>>, bool indexed = false>
 class LinkMap
 {
 private:
-    using Node = ListNode<V>;
-    using Map = std::map<K, Node, std::less<>>;
-
+    using Node = ListNode<V, indexed>;
     using RealPair = std::pair<const K, Node>;
+    using Map = std::map<K, Node, std::less<>, typename std::allocator_traits<A>::template rebind_alloc<RealPair>>;
+
     using Pair = std::pair<const K, V>;
     static_assert(alignof (RealPair) == alignof (Pair));
 
@@ -113,14 +297,32 @@ private:
 
 public:
     LinkMap() : m(), h{} {};
-    LinkMap(std::initializer_list<std::pair<K, V>> values) : LinkMap()
-    {
-        for(auto&& [key, value] : values) emplace(key, value);
-    }
+    explicit LinkMap(const A& alloc) : m(alloc), h{} {}
 
-	// TODO: impl move ctor
-	LinkMap(const LinkMap&) = delete;
-	LinkMap& operator=(const LinkMap&) & = delete;
+	// 按 [first, last) 的顺序插入，Key 重复时保留第一个；Key 递增的部分用 end 作提示，均摊 O(1)
+	template<typename It>
+	LinkMap(It first, It last, const A& alloc = A()) : LinkMap(alloc)
+	{
+		for(; first != last; ++first)
+		{
+			auto&& [key, value] = *first;
+			const auto n = m.size();
+			auto pos = m.try_emplace(m.end(), key, &h, ctor, value);
+			if(m.size() != n) append(&pos->second);
+		}
+	}
+
+    LinkMap(std::initializer_list<std::pair<K, V>> values, const A& alloc = A()) :
+		LinkMap(values.begin(), values.end(), alloc)
+	{}
+
+	// 节点原地留在 std::map 中，只需把首尾节点重新指向自己的 h，O(1)
+	LinkMap(LinkMap&& r) noexcept : m(std::move(r.m)), h{}, index(std::move(r.index)) { take(r); }
+	LinkMap& operator=(LinkMap&& r) &;
+
+	// 按 Key 顺序带提示插入，再按 r 的插入顺序重新串起链表，O(n log n)，只比较指针
+	LinkMap(const LinkMap& r);
+	LinkMap& operator=(const LinkMap& r) &;
 
 public:
 	using InsertResult = std::pair<V&, bool>;
@@ -130,12 +332,13 @@ public:
 	void erase(K& k) noexcept;
 	void erase(ListIter iter) noexcept;
 	void erase(MapIter iter) noexcept;
-	void clear() noexcept { m.clear(); h.reset(); }
+	void clear() noexcept;
 
     template<typename Key>
     bool contains(Key&& k) const noexcept { return m.find(k) != m.end(); }
 
     std::size_t size() const noexcept { return m.size(); }
+    A get_allocator() const noexcept { return A(m.get_allocator()); }
 
 	template<typename Key> V& at(Key&& k);
 	template<typename Key> const V& at(Key&& k) const;
@@ -152,13 +355,85 @@ public:
 	template<typename Key> ListIter list(Key&& key) &;
 	template<typename Key> std::size_t indexOf(Key&& key) const;
 
+	// 插入顺序中的最后一个元素，为空时返回 list().end()
+	ListIter back() & noexcept { return { static_cast<Node*>(h.pre), &h }; }
+
+	// 与 list(key) 相同，但找不到时返回 list().end()，不抛异常
+	template<typename Key> ListIter find(Key&& key) & noexcept;
+
+	// 把 iter 移到插入顺序的末尾，O(1)；indexed 时 O(log n)
+	void moveBack(ListIter iter) noexcept;
+
+	// 按插入顺序中的位置访问
+	ListIter listAt(std::size_t i) & { return { nodeAt(i), &h }; }
+	ListConstIter listAt(std::size_t i) const& { return { nodeAt(i), &h }; }
+	void eraseAt(std::size_t i) { erase(listAt(i)); }
+
+	// 插入到第 pos 个位置之前，pos >= size() 时与 emplace 相同；key 已存在时不移动
+	template<typename Key, typename... Vs> InsertResult emplaceAt(std::size_t pos, Key&& k, Vs&&... vs);
+
+private:
+	Node* nodeAt(std::size_t i) const
+	{
+		if(i >= size()) throw std::out_of_range("LinkMap: index is out of range!");
+		if constexpr(indexed)
+			return static_cast<Node*>(index.at(i));
+		else
+		{
+			// 从较近的一端开始数
+			auto n = const_cast<ListNodeBase*>(&h);
+			if(i < size() / 2)
+				for(n = n->next; i != 0; --i) n = n->next;
+			else
+				for(i = size() - i; i != 0; --i) n = n->pre;
+			return static_cast<Node*>(n);
+		}
+	}
+
+	std::size_t indexOfNode(const Node* node) const noexcept
+	{
+		if constexpr(indexed)
+			return index.rank(node);
+		else
+		{
+			std::size_t i = 0;
+			for(auto n = h.next; n != node; n = n->next) ++i;
+			return i;
+		}
+	}
+
+	void append(Node* node) noexcept
+	{
+		if constexpr(indexed) index.insert(node, nullptr);
+	}
+
+	void unindex(Node* node) noexcept
+	{
+		if constexpr(indexed) index.remove(node);
+	}
+
+	// r.m 已移入 m，接管 r 的链表
+	void take(LinkMap& r) noexcept
+	{
+		if(r.h.next != &r.h)
+		{
+			h.next = r.h.next;
+			h.pre = r.h.pre;
+			h.next->pre = &h;
+			h.pre->next = &h;
+		}
+		r.h.reset();
+		r.index = {};
+	}
+
 private:
     Map m;
     ListNodeBase h;
+    std::conditional_t<indexed, RankTree, NoRank> index;
 };
 
-template<typename K, typename V>
-class LinkMap<K, V>::MapIter : public Map::iterator
+template<typename K, typename V, typename A, bool indexed>
+class LinkMap<K, V, A, indexed>::MapIter : public Map::iterator
 {
 	friend LinkMap;
 	using Iter = typename Map::iterator;
@@ -197,13 +472,13 @@ private:
 	Map& m;
 };
 
-template<typename K, typename V>
-class LinkMap<K, V>::MapConstIter : public Map::const_iterator
+template<typename K, typename V, typename A, bool indexed>
+class LinkMap<K, V, A, indexed>::MapConstIter : public Map::const_iterator
 {
 	friend LinkMap;
 	using Iter = typename Map::const_iterator;
 private:
-	MapConstIter(Iter i, Map& m) : Iter(i), m(m) {}
+	MapConstIter(Iter i, const Map& m) : Iter(i), m(m) {}
 public:
 	DefaultClass(MapConstIter);
 
@@ -219,9 +494,9 @@ public:
 
 	const Pair* operator->() const { return std::addressof(**this); }
 
-	operator bool() const { return *this != m.end(); }
+	operator bool() const { return self() != m.end(); }
 
-	bool operator==(const MapIter& r) const noexcept { return self() == r.self(); }
+	bool operator==(const MapConstIter& r) const noexcept { return self() == r.self(); }
 
 	MapConstIter begin() const noexcept { return *this; }
 	MapConstIter end()	 const noexcept { return { m.end(), m }; }
@@ -234,11 +509,11 @@ private:
 	const Iter& self() const { return *this; }
 
 private:
-	Map& m;
+	const Map& m;
 };
 
-template<typename K, typename V>
-class LinkMap<K, V>::ListIter
+template<typename K, typename V, typename A, bool indexed>
+class LinkMap<K, V, A, indexed>::ListIter
 {
 private:
 	friend LinkMap;
@@ -272,7 +547,11 @@ public: // pointer-like
 
 	reference operator*() const { check(); return *objAddr(&node->value(), &Pair::second); }
 	Proxy operator->() const { check(); return Proxy{node}; }
-	reference operator[](int i) const { return *std::next(*this, i); }
+	reference operator[](int i) const
+	{
+		if constexpr(indexed) return *ListIter(owner()->nodeAt(index() + i), h);
+		else return *std::next(*this, i);
+	}
 
 	explicit operator bool() const noexcept { return node != h; }
 
@@ -290,8 +569,7 @@ public:
 	std::size_t index() const
 	{
 		check();
-		auto begin = ListIter(cast(h->next), h);
-		return std::distance(begin, *this);
+		return owner()->indexOfNode(node);
 	}
 
 private:
@@ -300,6 +578,8 @@ private:
 		if(node == h) throw std::out_of_range("This iterator is out of range!");
 	}
 
+	const LinkMap* owner() const noexcept { return objAddr(static_cast<const ListNodeBase*>(h), &LinkMap::h); }
+
 	static Node* cast(ListNodeBase* n) noexcept { return static_cast<Node*>(n); }
 
 private:
@@ -307,8 +587,8 @@ private:
 	ListNodeBase* const h;
 };
 
-template<typename K, typename V>
-class LinkMap<K, V>::ListConstIter
+template<typename K, typename V, typename A, bool indexed>
+class LinkMap<K, V, A, indexed>::ListConstIter
 {
 private:
 	friend LinkMap;
@@ -342,7 +622,11 @@ public: // pointer-like
 
 	reference operator*() const { check(); return *objAddr(&node->value(), &Pair::second); }
 	Proxy operator->() const { check(); return Proxy{node}; }
-	reference operator[](int i) const { return *std::next(*this, i); }
+	reference operator[](int i) const
+	{
+		if constexpr(indexed) return *ListConstIter(owner()->nodeAt(index() + i), h);
+		else return *std::next(*this, i);
+	}
 
 	explicit operator bool() const noexcept { return node != h; }
 
@@ -360,8 +644,7 @@ public:
 	std::size_t index() const
 	{
 		check();
-		auto begin = ListConstIter(cast(h->next), h);
-		return std::distance(begin, *this);
+		return owner()->indexOfNode(node);
 	}
 
 private:
@@ -370,6 +653,8 @@ private:
 		if(node == h) throw std::out_of_range("This iterator is out of range!");
 	}
 
+	const LinkMap* owner() const noexcept { return objAddr(h, &LinkMap::h); }
+
 	static const Node* cast(const ListNodeBase* n) noexcept
 	{
 		return static_cast<const Node*>(n);
@@ -380,69 +665,164 @@ private:
 	const ListNodeBase* const h;
 };
 
-template<typename K, typename V>
+template<typename K, typename V, typename A, bool indexed>
 template<typename Key, typename... Vs>
-std::pair<V&, bool> LinkMap<K, V>::insert(Key&& k, Vs&&... vs)
+std::pair<V&, bool> LinkMap<K, V, A, indexed>::insert(Key&& k, Vs&&... vs)
 {
 	auto [pos, b] =
 		m.try_emplace(std::forward<Key>(k), &h, init, std::forward<Vs>(vs)...);
+	if(b) append(&pos->second);
 	return {pos->second.value(), b};
 }
 
-template<typename K, typename V>
+template<typename K, typename V, typename A, bool indexed>
 template<typename Key, typename... Vs>
-std::pair<V&, bool> LinkMap<K, V>::emplace(Key&& k, Vs&&... vs)
+std::pair<V&, bool> LinkMap<K, V, A, indexed>::emplace(Key&& k, Vs&&... vs)
 {
 	auto [pos, b] =
 		m.try_emplace(std::forward<Key>(k), &h, ctor, std::forward<Vs>(vs)...);
+	if(b) append(&pos->second);
 	return {pos->second.value(), b};
 }
 
-template<typename K, typename V>
-void LinkMap<K, V>::erase(K& k) noexcept
+template<typename K, typename V, typename A, bool indexed>
+template<typename Key, typename... Vs>
+std::pair<V&, bool> LinkMap<K, V, A, indexed>::emplaceAt(std::size_t at, Key&& k, Vs&&... vs)
+{
+	const auto n = size();
+	auto [pos, b] =
+		m.try_emplace(std::forward<Key>(k), &h, ctor, std::forward<Vs>(vs)...);
+	if(!b) return {pos->second.value(), b};
+	auto node = &pos->second;
+	if(at >= n)
+		append(node);
+	else
+	{
+		// 新节点还在链表末尾、不在索引中，第 at 个仍是原来的节点
+		auto before = nodeAt(at);
+		node->move(before);
+		if constexpr(indexed) index.insert(node, before);
+	}
+	return {node->value(), b};
+}
+
+template<typename K, typename V, typename A, bool indexed>
+LinkMap<K, V, A, indexed>::LinkMap(const LinkMap& r) :
+	LinkMap(std::allocator_traits<A>::select_on_container_copy_construction(r.get_allocator()))
+{
+	// 两棵树的 Key 顺序相同，记下 r 的节点到新节点的对应，按地址排序后沿 r 的链表查找
+	std::vector<std::pair<const ListNodeBase*, Node*>> nodes;
+	nodes.reserve(r.size());
+	for(auto& [key, node] : r.m)
+	{
+		auto pos = m.try_emplace(m.end(), key, &h, ctor, node.value());
+		nodes.emplace_back(&node, &pos->second);
+	}
+	std::sort(nodes.begin(), nodes.end(), [](auto& a, auto& b) { return std::less<>{}(a.first, b.first); });
+	for(auto n = r.h.next; n != &r.h; n = n->next)
+	{
+		auto pos = std::lower_bound(nodes.begin(), nodes.end(), n,
+									[](auto& a, auto b) { return std::less<>{}(a.first, b); });
+		pos->second->move(&h);
+		append(pos->second);
+	}
+}
+
+template<typename K, typename V, typename A, bool indexed>
+auto LinkMap<K, V, A, indexed>::operator=(const LinkMap& r) & -> LinkMap&
+{
+	if(this != &r) *this = LinkMap(r);
+	return *this;
+}
+
+// 分配器不同且不随移动传播时，节点无法转移，只能逐个移动元素
+template<typename K, typename V, typename A, bool indexed>
+auto LinkMap<K, V, A, indexed>::operator=(LinkMap&& r) & -> LinkMap&
+{
+	if(this == &r) return *this;
+	clear();
+	using Traits = std::allocator_traits<typename Map::allocator_type>;
+	constexpr bool propagate = Traits::propagate_on_container_move_assignment::value;
+	if(propagate || m.get_allocator() == r.m.get_allocator())
+	{
+		// 已经 clear，交换后 r.m 为空；不用 std::map 的移动赋值，它会实例化逐个移动元素的分支
+		if constexpr(propagate) m = std::move(r.m);
+		else m.swap(r.m);
+		index = std::move(r.index);
+		take(r);
+	}
+	else
+	{
+		for(auto iter = r.list(); iter; ++iter) emplace(iter.key(), std::move(iter.value()));
+		r.clear();
+	}
+	return *this;
+}
+
+// 用 ArenaAllocator 且 K、V 都可平凡析构时，节点既不析构也不释放，直接丢弃整棵树，O(1)
+// 节点占用的内存留在 arena 中，通常紧接着调用 arena.release()
+template<typename K, typename V, typename A, bool indexed>
+void LinkMap<K, V, A, indexed>::clear() noexcept
+{
+	if constexpr(isArenaAllocator<A> && std::is_trivially_destructible_v<K> && std::is_trivially_destructible_v<V>)
+	{
+		auto alloc = m.get_allocator();
+		new(&m) Map(alloc);
+	}
+	else
+		m.clear();
+	h.reset();
+	index = {};
+}
+
+template<typename K, typename V, typename A, bool indexed>
+void LinkMap<K, V, A, indexed>::erase(K& k) noexcept
 {
     auto pos = m.find(k);
     if(pos == m.end()) return;
+    unindex(&pos->second);
     pos->second.remove();
     m.erase(pos);
 }
 
-template<typename K, typename V>
-void LinkMap<K, V>::erase(ListIter iter) noexcept
+template<typename K, typename V, typename A, bool indexed>
+void LinkMap<K, V, A, indexed>::erase(ListIter iter) noexcept
 {
     if(!iter) return;
+    unindex(iter.node);
     iter.node->remove();
     m.erase(iter.key());
 }
 
-template<typename K, typename V>
-void LinkMap<K, V>::erase(MapIter iter) noexcept
+template<typename K, typename V, typename A, bool indexed>
+void LinkMap<K, V, A, indexed>::erase(MapIter iter) noexcept
 {
     if(iter == m.end()) return;
-    iter->second.remove();
+    unindex(&iter.self()->second);
+    iter.self()->second.remove();
     m.erase(iter);
 }
 
-template<typename K, typename V>
+template<typename K, typename V, typename A, bool indexed>
 template<typename Key>
-const V& LinkMap<K, V>::at(Key&& k) const
+const V& LinkMap<K, V, A, indexed>::at(Key&& k) const
 {
     auto pos = m.find(k);
 	if(pos == m.cend()) throw std::exception();
     return pos->second.value();
 }
 
-template<typename K, typename V>
+template<typename K, typename V, typename A, bool indexed>
 template<typename Key>
-V& LinkMap<K, V>::at(Key&& k)
+V& LinkMap<K, V, A, indexed>::at(Key&& k)
 {
 	auto pos = m.find(k);
 	if(pos == m.cend()) throw std::exception();
 	return pos->second.value();
 }
 
-template<typename K, typename V>
-template<typename Key> V* LinkMap<K, V>::tryGet(Key&& k) noexcept
+template<typename K, typename V, typename A, bool indexed>
+template<typename Key> V* LinkMap<K, V, A, indexed>::tryGet(Key&& k) noexcept
 {
 	auto pos = m.find(k);
 	if(pos == m.cend())
@@ -451,8 +831,8 @@ template<typename Key> V* LinkMap<K, V>::tryGet(Key&& k) noexcept
 		return &pos->second.value();
 }
 
-template<typename K, typename V>
-template<typename Key> const V* LinkMap<K, V>::tryGet(Key&& k) const noexcept
+template<typename K, typename V, typename A, bool indexed>
+template<typename Key> const V* LinkMap<K, V, A, indexed>::tryGet(Key&& k) const noexcept
 {
 	auto pos = m.find(k);
 	if(pos == m.cend())
@@ -461,23 +841,49 @@ template<typename Key> const V* LinkMap<K, V>::tryGet(Key&& k) const noexcept
 		return &pos->second.value();
 }
 
-template<typename K, typename V>
+template<typename K, typename V, typename A, bool indexed>
 template<typename Key>
-auto LinkMap<K, V>::list(Key&& key) & -> LinkMap<K, V>::ListIter
+auto LinkMap<K, V, A, indexed>::list(Key&& key) & -> LinkMap<K, V, A, indexed>::ListIter
 {
 	auto pos = m.find(key);
 	if(pos == m.cend()) throw std::exception();
 	return {&pos->second, &h};
 }
 
-template<typename K, typename V>
+template<typename K, typename V, typename A, bool indexed>
 template<typename Key>
-std::size_t LinkMap<K, V>::indexOf(Key&& key) const
+auto LinkMap<K, V, A, indexed>::find(Key&& key) & noexcept -> LinkMap<K, V, A, indexed>::ListIter
+{
+	auto pos = m.find(key);
+	if(pos == m.end()) return {static_cast<Node*>(&h), &h};
+	return {&pos->second, &h};
+}
+
+template<typename K, typename V, typename A, bool indexed>
+void LinkMap<K, V, A, indexed>::moveBack(ListIter iter) noexcept
 {
-	auto& self = const_cast<LinkMap&>(*this);
-	auto pos = self.m.find(key);
+	if(!iter || iter.node->next == &h) return;
+	unindex(iter.node);
+	iter.node->move(&h);
+	append(iter.node);
+}
+
+template<typename K, typename V, typename A, bool indexed>
+template<typename Key>
+std::size_t LinkMap<K, V, A, indexed>::indexOf(Key&& key) const
+{
+	auto pos = m.find(key);
 	if(pos == m.cend()) throw std::exception();
-	return ListIter{&pos->second, &self.h}.index();
+	return indexOfNode(&pos->second);
 }
 
+template<typename K, typename V>
+using ArenaLinkMap = LinkMap<K, V, ArenaAllocator<std::pair<const K, V>>>;
+
+template<typename K, typename V>
+using PmrLinkMap = LinkMap<K, V, std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+
+template<typename K, typename V, typename A = std::allocator<std::pair<const K, V>>>
+using IndexedLinkMap = LinkMap<K, V, A, true>;
+
 #include <Utility/MacrosUndef.h>
@@ -0,0 +1,169 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <Utility/LinkedMap.h>
+
+// 最近最少使用（LRU）缓存，基于 LinkMap：插入顺序即使用顺序，命中时把节点移到末尾，淘汰时从头部开始
+// 按 Key 查找 O(log n)；LinkMap 不带位置索引，命中后移动节点只改几个链表指针，O(1)
+// 条目数超过 capacity，或各条目 weigh(k, v) 之和超过 budget 时淘汰，被淘汰的条目先交给 onEvict
+// 没有提供 weigh 时每个条目的权重为 0，budget 不起作用
+// 查找支持与 K 可比较的其他类型（如 std::string 与 std::string_view）
+// 不是线程安全的；onEvict 中不能再访问本缓存
+template<typename K, typename V>
+class LruCache
+{
+	struct Entry
+	{
+		V value;
+		std::size_t weight;
+	};
+	using Map = LinkMap<K, Entry>;
+
+public:
+	using Weigh = std::function<std::size_t(const K&, const V&)>;
+	using OnEvict = std::function<void(const K&, V&)>;
+
+	explicit LruCache(std::size_t capacity,
+					  std::size_t budget = std::numeric_limits<std::size_t>::max(),
+					  Weigh weigh = {}, OnEvict onEvict = {}) :
+		maxCount(capacity), maxBytes(budget), weigh(std::move(weigh)), onEvict(std::move(onEvict))
+	{}
+
+public:
+	// 命中时算作一次使用，计入 hits；否则计入 misses，返回 nullptr
+	template<typename Key>
+	V* get(const Key& k)
+	{
+		auto iter = map.find(k);
+		if(!iter)
+		{
+			++missCount;
+			return nullptr;
+		}
+		++hitCount;
+		map.moveBack(iter);
+		return &iter.value().value;
+	}
+
+	// 只查看，不改变使用顺序，也不计数
+	template<typename Key>
+	const V* peek(const Key& k) const
+	{
+		auto v = map.tryGet(k);
+		return v ? &v->value : nullptr;
+	}
+
+	template<typename Key>
+	bool contains(const Key& k) const { return map.contains(k); }
+
+	// 插入或替换，并算作一次使用，之后从最久未使用的开始淘汰到不超过上限
+	// 条目本身就超过 budget（或 capacity 为 0）时放不进缓存，返回 nullptr，其他条目不受影响；
+	// 此时如果是替换，旧值也一并删除（不调用 onEvict）
+	template<typename Key, typename... Vs>
+	V* put(Key&& k, Vs&&... vs)
+	{
+		V value(std::forward<Vs>(vs)...);
+		if(auto iter = map.find(k))
+		{
+			auto& entry = iter.value();
+			const auto w = weighOf(iter.key(), value);
+			bytes -= entry.weight;
+			if(!fits(w))
+			{
+				map.erase(iter);
+				return nullptr;
+			}
+			entry.value = std::move(value);
+			entry.weight = w;
+			bytes += w;
+			map.moveBack(iter);
+			settle();
+			return &entry.value;
+		}
+		K key(std::forward<Key>(k));
+		const auto w = weighOf(key, value);
+		if(!fits(w)) return nullptr;
+		auto& entry = map.insert(std::move(key), std::move(value), w).first;
+		bytes += w;
+		settle();
+		return &entry.value;
+	}
+
+	// 主动删除不调用 onEvict
+	template<typename Key>
+	bool erase(const Key& k)
+	{
+		auto iter = map.find(k);
+		if(!iter) return false;
+		bytes -= iter.value().weight;
+		map.erase(iter);
+		return true;
+	}
+
+	void clear() noexcept
+	{
+		map.clear();
+		bytes = 0;
+	}
+
+	// 调整上限，立即淘汰超出的部分
+	void resize(std::size_t capacity, std::size_t budget = std::numeric_limits<std::size_t>::max())
+	{
+		maxCount = capacity;
+		maxBytes = budget;
+		while(over() && map.size() != 0) evictFront();
+	}
+
+public:
+	std::size_t size() const noexcept { return map.size(); }
+	std::size_t capacity() const noexcept { return maxCount; }
+	std::size_t weight() const noexcept { return bytes; }
+	std::size_t budget() const noexcept { return maxBytes; }
+
+	std::uint64_t hits() const noexcept { return hitCount; }
+	std::uint64_t misses() const noexcept { return missCount; }
+	std::uint64_t evictions() const noexcept { return evictCount; }
+	void resetStats() noexcept { hitCount = missCount = evictCount = 0; }
+
+	// 从最久未使用到最近使用遍历，不改变使用顺序
+	template<typename F>
+	void forEach(F&& f) const
+	{
+		for(auto iter = map.list(); iter; ++iter) f(iter.key(), iter.value().value);
+	}
+
+private:
+	bool over() const noexcept { return map.size() > maxCount || bytes > maxBytes; }
+
+	std::size_t weighOf(const K& k, const V& v) const { return weigh ? weigh(k, v) : 0; }
+
+	bool fits(std::size_t weight) const noexcept { return maxCount != 0 && weight <= maxBytes; }
+
+	// 末尾的条目单独能放下，淘汰到它之前就会停止
+	void settle()
+	{
+		while(over()) evictFront();
+	}
+
+	void evictFront()
+	{
+		auto iter = map.list();
+		if(onEvict) onEvict(iter.key(), iter.value().value);
+		bytes -= iter.value().weight;
+		map.erase(iter);
+		++evictCount;
+	}
+
+private:
+	Map map;
+	std::size_t maxCount;
+	std::size_t maxBytes;
+	std::size_t bytes = 0;
+	Weigh weigh;
+	OnEvict onEvict;
+	std::uint64_t hitCount = 0;
+	std::uint64_t missCount = 0;
+	std::uint64_t evictCount = 0;
+};
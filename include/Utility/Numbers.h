@@ -0,0 +1,15 @@
+#pragma once
+
+// 数学常数：C++20 起即 std::numbers，之前只提供 pi
+#if __cplusplus < 202002L
+namespace Numbers
+{
+inline constexpr double pi = 3.141592653589793;
+}
+#else
+#include <numbers>
+namespace Numbers
+{
+using namespace std::numbers;
+}
+#endif
@@ -1,5 +1,8 @@
 #pragma once
 #include <random>
+#include <array>
+#include <cstdint>
+#include <limits>
 
 namespace Randoms
 {
@@ -74,6 +77,92 @@ namespace Randoms
 			return GaussRandom((lower + upper) / 2, std::abs(upper - lower) / 6);
 		}
 	};
+
+	/// 基于计数器的随机数 Philox4x32-10 (Salmon et al., SC'11)
+	/// 结果只由 key 和 counter 决定，没有内部状态：可以多线程共享、任意跳跃，
+	/// 分段并行生成的结果与顺序生成完全一致
+	class Philox
+	{
+	public:
+		using Block = std::array<std::uint32_t, 4>;
+
+		explicit constexpr Philox(std::uint64_t key) noexcept :
+			key{std::uint32_t(key), std::uint32_t(key >> 32)}
+		{}
+
+		constexpr Block operator()(std::uint64_t counter, std::uint64_t stream = 0) const noexcept
+		{
+			return (*this)(Block{std::uint32_t(counter), std::uint32_t(counter >> 32),
+								 std::uint32_t(stream), std::uint32_t(stream >> 32)});
+		}
+
+		constexpr Block operator()(Block c) const noexcept
+		{
+			std::uint32_t k0 = key[0], k1 = key[1];
+			for(int round = 0; round != 10; ++round)
+			{
+				if(round != 0) k0 += 0x9E3779B9, k1 += 0xBB67AE85;
+				const std::uint64_t p0 = std::uint64_t(0xD2511F53) * c[0];
+				const std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c[2];
+				c = {std::uint32_t(p1 >> 32) ^ c[1] ^ k0, std::uint32_t(p1),
+					 std::uint32_t(p0 >> 32) ^ c[3] ^ k1, std::uint32_t(p0)};
+			}
+			return c;
+		}
+
+		/// 两个 [0, 1) 上均匀分布的 double
+		constexpr std::array<double, 2> uniform(std::uint64_t counter, std::uint64_t stream = 0) const noexcept
+		{
+			auto b = (*this)(counter, stream);
+			return {unit(b[0], b[1]), unit(b[2], b[3])};
+		}
+
+		static constexpr double unit(std::uint32_t lo, std::uint32_t hi) noexcept
+		{
+			auto bits = (std::uint64_t(hi) << 32 | lo) >> 11;
+			return double(bits) * (1. / 9007199254740992.); // 2^-53
+		}
+
+	private:
+		std::uint32_t key[2];
+	};
+
+	/// 满足 UniformRandomBitGenerator 的 Philox，可以配合 std 的各种分布使用
+	/// 每个 (seed, stream) 是一条独立的序列
+	class PhiloxEngine
+	{
+	public:
+		using result_type = std::uint32_t;
+
+		explicit PhiloxEngine(std::uint64_t seed, std::uint64_t stream = 0) noexcept :
+			philox(seed), stream(stream)
+		{}
+
+		static constexpr result_type min() noexcept { return 0; }
+		static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		result_type operator()() noexcept
+		{
+			if(used == 4) block = philox(counter++, stream), used = 0;
+			return block[used++];
+		}
+
+		// 已经输出了 counter * 4 - (4 - used) 个数，counter 总是指向下一块
+		void discard(unsigned long long n) noexcept
+		{
+			const std::uint64_t next = counter * 4 - (4 - used) + n;
+			counter = next / 4;
+			used = 4;
+			if(next % 4 != 0) block = philox(counter++, stream), used = int(next % 4);
+		}
+
+	private:
+		Philox philox;
+		std::uint64_t stream;
+		std::uint64_t counter = 0;
+		Philox::Block block{};
+		int used = 4;
+	};
 }
 
 using Randoms::RandomNumber;
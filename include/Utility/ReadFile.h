@@ -1,10 +1,33 @@
 #pragma once
 #include <filesystem>
 #include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <string>
+#include "DataView.h"
 
-/// read content of a file with the help of std only
+// platform APIs for MappedFile only; min/max below are parenthesized in case Windows.h defines them as macros
+#if defined(_WIN32)
+#  include <Windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/// read content of a file with std streams, or through a read-only memory mapping (MappedFile)
 namespace ReadFiles
 {
 namespace fs = std::filesystem;
@@ -49,6 +72,242 @@ inline std::string readText(const fs::path& file)
 	return content;
 }
 
+// expected access pattern, passed to madvise after mapping (ignored on Windows)
+enum class Access { Normal, Sequential, Random, WillNeed };
+
+// read-only memory mapping of a file, unmapped on destruction; move only
+// pages come from the page cache on demand, no read-and-copy through ifstream.
+// an empty file is not mapped and view() is empty
+class MappedFile
+{
+public:
+	explicit MappedFile(const fs::path& file, Access access = Access::Sequential)
+	{
+#if defined(_WIN32)
+		auto handle = ::CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+									FILE_ATTRIBUTE_NORMAL, nullptr);
+		if(handle == INVALID_HANDLE_VALUE) throw std::runtime_error("can't open file:" + file.string());
+		::LARGE_INTEGER length{};
+		if(!::GetFileSizeEx(handle, &length))
+		{
+			::CloseHandle(handle);
+			throw std::runtime_error("can't get size of file:" + file.string());
+		}
+		size = std::size_t(length.QuadPart);
+		if(size != 0)
+		{
+			auto mapping = ::CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if(mapping) data = static_cast<const char*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			if(mapping) ::CloseHandle(mapping);
+		}
+		::CloseHandle(handle);
+#else
+		int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+		if(fd < 0) throw std::runtime_error("can't open file:" + file.string());
+		struct ::stat st{};
+		if(::fstat(fd, &st) != 0)
+		{
+			::close(fd);
+			throw std::runtime_error("can't get size of file:" + file.string());
+		}
+		size = std::size_t(st.st_size);
+		if(size != 0)
+		{
+			void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(p != MAP_FAILED) data = static_cast<const char*>(p);
+		}
+		::close(fd);
+#endif
+		if(size != 0 && !data) throw std::runtime_error("can't map file:" + file.string());
+		advise(access);
+	}
+
+	~MappedFile() { unmap(); }
+
+	MappedFile(MappedFile&& other) noexcept :
+		data(std::exchange(other.data, nullptr)),
+		size(std::exchange(other.size, 0))
+	{}
+
+	MappedFile& operator=(MappedFile&& other) noexcept
+	{
+		if(this != &other)
+		{
+			unmap();
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0);
+		}
+		return *this;
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+	DataViews::DataView<const char> view() const noexcept { return {data, size}; }
+	operator DataViews::DataView<const char>() const noexcept { return view(); }
+	DataViews::CRawView raw() const noexcept { return {data, size}; }
+
+	// hint again when the access pattern changes, e.g. a sequential index scan followed by random lookups
+	void advise([[maybe_unused]] Access access) const noexcept
+	{
+#if !defined(_WIN32)
+		if(!data) return;
+		const int advice[] = {MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED};
+		::madvise(const_cast<char*>(data), size, advice[int(access)]);
+#endif
+	}
+
+private:
+	void unmap() noexcept
+	{
+		if(!data) return;
+#if defined(_WIN32)
+		::UnmapViewOfFile(data);
+#else
+		::munmap(const_cast<char*>(data), size);
+#endif
+		data = nullptr;
+	}
+
+private:
+	const char* data = nullptr;
+	std::size_t size = 0;
+};
+
+inline MappedFile mmapFile(const fs::path& file, Access access = Access::Sequential)
+{
+	return MappedFile(file, access);
+}
+
+namespace Detail
+{
+// incremental UTF-8 validator (RFC 3629: no overlongs, surrogates or code points above U+10FFFF)
+// ASCII runs are skipped 8 bytes at a time, other bytes go through a small state machine
+class Utf8
+{
+public:
+	static constexpr std::size_t npos = std::size_t(-1);
+
+	// offset of the first invalid sequence, counted over all bytes fed so far, or npos
+	std::size_t feed(const char* data, std::size_t n) noexcept
+	{
+		auto p = reinterpret_cast<const unsigned char*>(data);
+		for(std::size_t i = 0; i != n;)
+		{
+			if(need == 0)
+			{
+				for(std::uint64_t word; i + 8 <= n; i += 8)
+				{
+					std::memcpy(&word, p + i, 8);
+					if(word & 0x8080808080808080ull) break;
+				}
+				if(i == n) break;
+				const unsigned char c = p[i];
+				if(c < 0x80) { ++i; continue; }
+
+				start = pos + i;
+				lo = 0x80, hi = 0xBF;
+				if(c >= 0xC2 && c <= 0xDF) need = 1;
+				else if(c == 0xE0) need = 2, lo = 0xA0;
+				else if(c == 0xED) need = 2, hi = 0x9F;
+				else if(c >= 0xE1 && c <= 0xEF) need = 2;
+				else if(c == 0xF0) need = 3, lo = 0x90;
+				else if(c == 0xF4) need = 3, hi = 0x8F;
+				else if(c >= 0xF1 && c <= 0xF3) need = 3;
+				else return start;
+			}
+			else
+			{
+				const unsigned char c = p[i];
+				if(c < lo || c > hi) return start;
+				lo = 0x80, hi = 0xBF;
+				--need;
+			}
+			++i;
+		}
+		pos += n;
+		return npos;
+	}
+
+	// npos if the input did not stop inside a sequence
+	std::size_t finish() const noexcept { return need == 0 ? npos : start; }
+
+private:
+	std::size_t pos = 0;
+	std::size_t start = 0;
+	int need = 0;
+	unsigned char lo = 0x80, hi = 0xBF;
+};
+} // namespace Detail
+
+// offset of the first invalid UTF-8 sequence in text, or npos if it is valid
+inline std::size_t validateUtf8(std::string_view text) noexcept
+{
+	Detail::Utf8 utf8;
+	auto error = utf8.feed(text.data(), text.size());
+	return error != Detail::Utf8::npos ? error : utf8.finish();
+}
+
+class Utf8Error : public std::runtime_error
+{
+public:
+	Utf8Error(const fs::path& file, std::size_t offset) :
+		std::runtime_error("invalid UTF-8 at byte " + std::to_string(offset) + " of file:" + file.string()),
+		at(offset)
+	{}
+
+	// byte offset in the text with '\0' padding removed
+	std::size_t offset() const noexcept { return at; }
+
+private:
+	std::size_t at;
+};
+
+// same result as readText, but in one pass: the '\0' padding is dropped while reading
+// chunk by chunk (no erase afterwards) and the text is validated as UTF-8 on the way
+// throws Utf8Error with the offset of the first invalid sequence
+inline std::string readUtf8(const fs::path& file, std::size_t chunk = 1 << 20)
+{
+	auto size = fs::file_size(file);
+	if(size == 0) return {};
+	auto stream = Detail::getStream(file);
+	std::string content(size, '\0');
+	chunk = (std::max<std::size_t>)(chunk, 1);
+
+	Detail::Utf8 utf8;
+	std::size_t length = 0, kept = 0, error = Detail::Utf8::npos;
+	while(length != size)
+	{
+		auto p = content.data() + length;
+		stream.read(p, std::streamsize((std::min)(chunk, size - length)));
+		auto n = std::size_t(stream.gcount());
+		if(n == 0) break;
+
+		// leading padding: only possible while nothing has been kept
+		if(length == 0)
+		{
+			auto first = std::find_if(p, p + n, [](char c) { return c != '\0'; });
+			std::memmove(p, first, std::size_t(p + n - first));
+			n = std::size_t(p + n - first);
+			if(n == 0) continue;
+		}
+		if(error == Detail::Utf8::npos) error = utf8.feed(p, n);
+		for(auto i = n; i != 0; --i)
+			if(p[i - 1] != '\0')
+			{
+				kept = length + i;
+				break;
+			}
+		length += n;
+	}
+	content.resize(kept);
+
+	if(error == Detail::Utf8::npos) error = utf8.finish();
+	if(error != Detail::Utf8::npos) throw Utf8Error(file, error);
+	return content;
+}
+
 inline std::vector<std::string> readLines(const fs::path& file)
 {
 	auto size = fs::file_size(file);
@@ -59,4 +318,215 @@ inline std::vector<std::string> readLines(const fs::path& file)
 	while(std::getline(stream, tmp)) lines.push_back(std::move(tmp));
 	return lines;
 }
+
+// iterate lines as string_views without allocating per line
+// from a file: reads chunk by chunk and holds about one chunk (doubled when a line is longer);
+// from memory (e.g. mmapFile().view()): the views point into the original data
+// both "\n" and "\r\n" are stripped; like std::getline, a final newline gives no extra empty line
+// NOTE: lines read from a file are only valid until the next call of next()
+class LineReader
+{
+public:
+	explicit LineReader(const fs::path& file, std::size_t chunk = 1 << 20) :
+		stream(std::make_unique<std::ifstream>(file, std::ios::binary)),
+		buffer((std::max<std::size_t>)(chunk, 1))
+	{
+		if(!stream->is_open()) throw std::runtime_error("can't open file:" + file.string());
+	}
+
+	explicit LineReader(DataViews::DataView<const char> text) noexcept :
+		text(text.data),
+		last(text.size)
+	{}
+
+	bool next(std::string_view& line)
+	{
+		while(true)
+		{
+			const char* base = data();
+			auto nl = pos == last ? nullptr : static_cast<const char*>(std::memchr(base + pos, '\n', last - pos));
+			if(nl)
+			{
+				line = trim(base + pos, nl);
+				pos = std::size_t(nl - base) + 1;
+				return true;
+			}
+			if(!fill())
+			{
+				if(pos == last) return false;
+				line = {data() + pos, last - pos};
+				pos = last;
+				return true;
+			}
+		}
+	}
+
+	struct End {};
+
+	class Iterator
+	{
+	public:
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using iterator_category = std::input_iterator_tag;
+
+		explicit Iterator(LineReader& r) : r(&r) { ++*this; }
+
+		const std::string_view& operator*() const noexcept { return line; }
+		const std::string_view* operator->() const noexcept { return &line; }
+		Iterator& operator++() { if(!r->next(line)) r = nullptr; return *this; }
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const Iterator& i, End) noexcept { return !i.r; }
+		friend bool operator!=(const Iterator& i, End e) noexcept { return !(i == e); }
+
+	private:
+		LineReader* r;
+		std::string_view line;
+	};
+
+	Iterator begin() { return Iterator(*this); }
+	End end() const noexcept { return {}; }
+
+private:
+	const char* data() const noexcept { return stream ? buffer.data() : text; }
+
+	static std::string_view trim(const char* first, const char* nl) noexcept
+	{
+		if(nl != first && nl[-1] == '\r') --nl;
+		return {first, std::size_t(nl - first)};
+	}
+
+	// move the unconsumed tail to the front and read one more chunk; false if nothing is left
+	bool fill()
+	{
+		if(!stream || !*stream) return false;
+		if(pos != 0)
+		{
+			std::memmove(buffer.data(), buffer.data() + pos, last - pos);
+			last -= pos;
+			pos = 0;
+		}
+		if(last == buffer.size()) buffer.resize(buffer.size() * 2);
+		stream->read(buffer.data() + last, std::streamsize(buffer.size() - last));
+		auto count = std::size_t(stream->gcount());
+		last += count;
+		return count != 0;
+	}
+
+private:
+	std::unique_ptr<std::ifstream> stream;
+	std::vector<char> buffer;
+	const char* text = nullptr;
+	std::size_t pos = 0;
+	std::size_t last = 0;
+};
+
+inline LineReader lines(const fs::path& file, std::size_t chunk = 1 << 20)
+{
+	return LineReader(file, chunk);
+}
+
+// the lines point into the mapping, which must outlive the iteration; use LineReader(view) for other memory
+inline LineReader lines(const MappedFile& mapped) noexcept
+{
+	return LineReader(mapped.view());
+}
+
+namespace Detail
+{
+// reading files mostly waits on IO, so use more threads than cores
+inline std::size_t ioThreads(std::size_t jobs, std::size_t threads)
+{
+	if(threads == 0) threads = std::clamp<std::size_t>(2 * std::thread::hardware_concurrency(), 2, 16);
+	return (std::min)(jobs, threads);
+}
+
+// each thread takes indices from a shared counter and calls job(i), which must not throw
+// if a thread can't be created, the ones already running take all the jobs; throws only if none started
+template<typename F>
+inline std::vector<std::thread> spawn(std::size_t jobs, std::size_t threads, F job)
+{
+	auto next = std::make_shared<std::atomic<std::size_t>>(0);
+	const auto n = ioThreads(jobs, threads);
+	std::vector<std::thread> workers;
+	workers.reserve(n);
+	try
+	{
+		for(std::size_t t = 0; t != n; ++t)
+			workers.emplace_back([=] {
+				for(std::size_t i; (i = (*next)++) < jobs;) job(i);
+			});
+	}
+	catch(...)
+	{
+		if(workers.empty()) throw;
+	}
+	return workers;
+}
+} // namespace Detail
+
+// read a batch of files concurrently, starting in the background on construction; one future per file
+// errors such as a missing file are rethrown by that file's future; the destructor waits for all reads
+// no platform API like io_uring, just a few threads calling readFile
+class BatchRead
+{
+public:
+	explicit BatchRead(std::vector<fs::path> files, std::size_t threads = 0) :
+		files(std::move(files)),
+		promises(this->files.size())
+	{
+		for(auto& p : promises) futures.push_back(p.get_future());
+		workers = Detail::spawn(this->files.size(), threads, [this](std::size_t i) {
+			try { promises[i].set_value(readFile(this->files[i])); }
+			catch(...) { promises[i].set_exception(std::current_exception()); }
+		});
+	}
+
+	~BatchRead()
+	{
+		for(auto& w : workers) w.join();
+	}
+
+	BatchRead(const BatchRead&) = delete;
+	BatchRead& operator=(const BatchRead&) = delete;
+
+public:
+	std::size_t size() const noexcept { return files.size(); }
+	const fs::path& path(std::size_t i) const noexcept { return files[i]; }
+	std::future<std::vector<char>>& operator[](std::size_t i) noexcept { return futures[i]; }
+
+	// wait for file i and take its content, only once per file
+	std::vector<char> get(std::size_t i) { return futures[i].get(); }
+
+private:
+	const std::vector<fs::path> files;
+	std::vector<std::promise<std::vector<char>>> promises;
+	std::vector<std::future<std::vector<char>>> futures;
+	std::vector<std::thread> workers;
+};
+
+// callback version: done(index, content, error) is called on a worker thread as each file finishes,
+// with an empty content and a non-null error on failure. done may run concurrently; returns when all are done
+// if done throws, no further files are started and the first such exception is rethrown here after all threads end
+template<typename F>
+inline void readFiles(const std::vector<fs::path>& files, F&& done, std::size_t threads = 0)
+{
+	std::atomic<bool> failed = false;
+	std::exception_ptr doneError;
+	auto workers = Detail::spawn(files.size(), threads, [&](std::size_t i) {
+		if(failed.load(std::memory_order_relaxed)) return;
+		std::vector<char> content;
+		std::exception_ptr error;
+		try { content = readFile(files[i]); }
+		catch(...) { error = std::current_exception(); }
+		try { done(i, std::move(content), error); }
+		catch(...)
+		{
+			if(!failed.exchange(true)) doneError = std::current_exception();
+		}
+	});
+	for(auto& w : workers) w.join();
+	if(doneError) std::rethrow_exception(doneError);
+}
 } // namespace ReadFiles
@@ -0,0 +1,116 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include "FFT.h"
+#include "Numbers.h"
+
+// 流式短时傅里叶变换
+// 样本可以按任意长度分批 push，内部用长度为 N 的环形缓冲区保存最近的 N 个样本，
+// 每隔 hop 个样本对最近 N 个样本加窗并变换一次；构造之后不再分配内存
+class STFT
+{
+public:
+	enum Window { Rectangle, Hann, Blackman, FlatTop };
+
+	STFT(std::size_t N, std::size_t hop, Window window = Hann,
+		 FFTRigor rigor = FFTRigor::Estimate) :
+		f(N, rigor),
+		w(makeWindow(N, window)),
+		ring(N),
+		head(0),
+		pending(N),
+		step(hop == 0 ? 1 : hop)
+	{}
+
+public:
+	std::size_t size() const noexcept { return f.size(); }
+	std::size_t hop() const noexcept { return step; }
+	const FFT& fft() const noexcept { return f; }
+	DataViews::DataView<const double> window() const noexcept { return w; }
+
+	// 每凑齐一帧就调用一次 emit(const FFT&)，返回本次产生的帧数
+	template<typename F>
+	std::size_t push(DataViews::DataView<const double> samples, F&& emit)
+	{
+		std::size_t frames = 0;
+		auto pos = samples.begin();
+		while(pos != samples.end())
+		{
+			auto count = std::min(pending, std::size_t(samples.end() - pos));
+			write(pos, count);
+			pos += count;
+			pending -= count;
+			if(pending != 0) break;
+
+			frame();
+			emit(static_cast<const FFT&>(f));
+			pending = step;
+			++frames;
+		}
+		return frames;
+	}
+
+	// 丢弃已缓存的样本，下一帧重新等待 N 个样本
+	void reset() noexcept
+	{
+		head = 0;
+		pending = size();
+	}
+
+	static std::vector<double> makeWindow(std::size_t N, Window window)
+	{
+		using Numbers::pi;
+		std::vector<double> w(N, 1.);
+		auto coef = [&](std::initializer_list<double> as) {
+			for(std::size_t n = 0; n != N; ++n)
+			{
+				double x = 2 * pi * double(n) / double(N), v = 0, sign = 1;
+				int k = 0;
+				for(double a : as) v += sign * a * std::cos(k++ * x), sign = -sign;
+				w[n] = v;
+			}
+		};
+		switch(window)
+		{
+		case Hann: coef({0.5, 0.5}); break;
+		case Blackman: coef({0.42, 0.5, 0.08}); break;
+		case FlatTop: coef({0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368}); break;
+		case Rectangle: break;
+		}
+		return w;
+	}
+
+private:
+	void write(const double* data, std::size_t count) noexcept
+	{
+		const auto N = size();
+		if(count >= N)
+		{
+			data += count - N;
+			count = N;
+		}
+		auto first = std::min(count, N - head);
+		std::copy(data, data + first, ring.begin() + head);
+		std::copy(data + first, data + count, ring.begin());
+		head = (head + count) % N;
+	}
+
+	// ring[head] 是最旧的样本
+	void frame() noexcept
+	{
+		auto in = f.buffer();
+		auto split = ring.size() - head;
+		std::transform(ring.begin() + head, ring.end(), w.begin(), in.begin(), std::multiplies<>{});
+		std::transform(ring.begin(), ring.begin() + head, w.begin() + split, in.begin() + split,
+					   std::multiplies<>{});
+		f.calc();
+	}
+
+private:
+	FFT f;
+	const std::vector<double> w;
+	std::vector<double> ring;
+	std::size_t head;    // 下一个样本写入的位置
+	std::size_t pending; // 距离下一帧还差的样本数
+	const std::size_t step;
+};
@@ -1,20 +1,19 @@
 #pragma once
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <execution>
+#include <type_traits>
+#include <vector>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
 #include "RandomNumber.h"
-
-// π
-#if __cplusplus < 202002L
-namespace Numbers
-{
-inline constexpr double pi = 3.141592653589793;
-}
-#else
-#include <numbers>
-namespace Numbers
-{
-using namespace std::numbers;
-}
-#endif
+#include "DataView.h"
+#include "Numbers.h"
 
 namespace SignalSequence
 {
@@ -28,6 +27,157 @@ inline auto toSec(T t)
 	return std::chrono::duration_cast<Seconds>(t);
 }
 
+// 采样时刻：第 i 个点位于 begin + i·dT
+struct Sampling
+{
+	Seconds at(std::size_t i) const { return begin + Seconds(double(i) * dT); }
+
+	Seconds begin;
+	double dT;
+};
+
+// 信号节点的基类
+// at(s) 求第 s 秒的值；block(sampling, first, out) 一次求 out.size 个点，
+// out[i] 对应第 first + i 个采样时刻；派生类可以用更快的实现覆盖 block
+template<typename D>
+struct Signal
+{
+	template<typename T>
+	double operator()(T t) const { return self().at(toSec(t).count()); }
+
+	void block(Sampling sampling, std::size_t first, DataViews::DataView<double> out) const
+	{
+		for(std::size_t i = 0; i != out.size; ++i) out.data[i] = self().at(sampling.at(first + i).count());
+	}
+
+private:
+	const D& self() const { return static_cast<const D&>(*this); }
+};
+
+namespace Detail
+{
+template<typename F, typename = void>
+struct HasBlock : std::false_type {};
+
+template<typename F>
+struct HasBlock<F, std::void_t<decltype(std::declval<const F&>().block(
+	Sampling{}, std::size_t{}, std::declval<DataViews::DataView<double>>()))>> : std::true_type {};
+
+// 普通的 lambda 没有 block，逐点求值
+template<typename F>
+inline void block(const F& f, Sampling sampling, std::size_t first, DataViews::DataView<double> out)
+{
+	if constexpr(HasBlock<F>::value)
+		f.block(sampling, first, out);
+	else
+		for(std::size_t i = 0; i != out.size; ++i) out.data[i] = f(sampling.at(first + i));
+}
+
+template<typename F>
+inline double at(const F& f, double seconds)
+{
+	if constexpr(HasBlock<F>::value)
+		return f.at(seconds);
+	else
+		return f(Seconds(seconds));
+}
+
+template<typename F, typename = void>
+struct HasDescribe : std::false_type {};
+
+template<typename F>
+struct HasDescribe<F, std::void_t<decltype(std::declval<const F&>().describe())>> : std::true_type {};
+
+// 普通的 lambda 无法查看内部，记为 f(t)
+template<typename F>
+inline std::string describe(const F& f)
+{
+	if constexpr(HasDescribe<F>::value)
+		return f.describe();
+	else
+		return "f(t)";
+}
+
+template<typename... Args>
+inline std::string format(const Args&... args)
+{
+	std::ostringstream os;
+	(os << ... << args);
+	return os.str();
+}
+
+template<typename Op> constexpr char symbol = '?';
+template<> inline constexpr char symbol<std::plus<>> = '+';
+template<> inline constexpr char symbol<std::minus<>> = '-';
+template<> inline constexpr char symbol<std::multiplies<>> = '*';
+template<> inline constexpr char symbol<std::divides<>> = '/';
+
+inline constexpr std::size_t chunk = 256;
+// 并行生成时每个任务的点数，是 chunk 和 Wave 重新播种间隔的整数倍，
+// 保证切分后每段内部的求值步骤与串行时完全相同
+inline constexpr std::size_t slice = 64 * 1024;
+} // namespace Detail
+
+struct Constant : Signal<Constant>
+{
+	explicit Constant(double value) : value(value) {}
+
+	double at(double) const { return value; }
+
+	void block(Sampling, std::size_t, DataViews::DataView<double> out) const
+	{
+		std::fill(out.begin(), out.end(), value);
+	}
+
+	std::string describe() const { return Detail::format(value); }
+
+	double value;
+};
+
+// 二元运算：block 分段进行，左侧写入 out，右侧写入栈上的缓冲区后就地合并；
+// 一侧是常数时不再展开成缓冲区，直接在另一侧的结果上做一遍标量运算
+template<typename Op, typename F1, typename F2>
+struct Binary : Signal<Binary<Op, F1, F2>>
+{
+	Binary(F1 f1, F2 f2) : f1(std::move(f1)), f2(std::move(f2)) {}
+
+	double at(double seconds) const { return Op{}(Detail::at(f1, seconds), Detail::at(f2, seconds)); }
+
+	void block(Sampling sampling, std::size_t first, DataViews::DataView<double> out) const
+	{
+		if constexpr(std::is_same_v<F2, Constant>)
+		{
+			Detail::block(f1, sampling, first, out);
+			for(auto& v : out) v = Op{}(v, f2.value);
+		}
+		else if constexpr(std::is_same_v<F1, Constant>)
+		{
+			Detail::block(f2, sampling, first, out);
+			for(auto& v : out) v = Op{}(f1.value, v);
+		}
+		else
+		{
+			double scratch[Detail::chunk];
+			for(std::size_t pos = 0; pos < out.size; pos += Detail::chunk)
+			{
+				auto count = std::min(Detail::chunk, out.size - pos);
+				auto dst = out.data + pos;
+				Detail::block(f1, sampling, first + pos, {dst, count});
+				Detail::block(f2, sampling, first + pos, {scratch, count});
+				for(std::size_t i = 0; i != count; ++i) dst[i] = Op{}(dst[i], scratch[i]);
+			}
+		}
+	}
+
+	std::string describe() const
+	{
+		return Detail::format('(', Detail::describe(f1), ' ', Detail::symbol<Op>, ' ', Detail::describe(f2), ')');
+	}
+
+	F1 f1;
+	F2 f2;
+};
+
 inline namespace Operators
 {
 template<typename F, typename = void>
@@ -40,32 +190,38 @@ struct IsCallable<F,
 	std::true_type
 {};
 
+// 两个常数直接折叠成一个常数
+inline Constant operator+(Constant a, Constant b) { return Constant(a.value + b.value); }
+inline Constant operator-(Constant a, Constant b) { return Constant(a.value - b.value); }
+inline Constant operator*(Constant a, Constant b) { return Constant(a.value * b.value); }
+inline Constant operator/(Constant a, Constant b) { return Constant(a.value / b.value); }
+
 template<typename F1, typename F2,
 		 std::enable_if_t<IsCallable<F1>::value && IsCallable<F2>::value, int> = 0>
 inline auto operator+(F1 f1, F2 f2)
 {
-	return [f1, f2](auto t) { return f1(t) + f2(t); };
+	return Binary<std::plus<>, F1, F2>(std::move(f1), std::move(f2));
 }
 
 template<typename F1, typename F2,
 		 std::enable_if_t<IsCallable<F1>::value && IsCallable<F2>::value, int> = 0>
 inline auto operator-(F1 f1, F2 f2)
 {
-	return [f1, f2](auto t) { return f1(t) - f2(t); };
+	return Binary<std::minus<>, F1, F2>(std::move(f1), std::move(f2));
 }
 
 template<typename F1, typename F2,
 		 std::enable_if_t<IsCallable<F1>::value && IsCallable<F2>::value, int> = 0>
 inline auto operator*(F1 f1, F2 f2)
 {
-	return [f1, f2](auto t) { return f1(t) * f2(t); };
+	return Binary<std::multiplies<>, F1, F2>(std::move(f1), std::move(f2));
 }
 
 template<typename F1, typename F2,
 		 std::enable_if_t<IsCallable<F1>::value && IsCallable<F2>::value, int> = 0>
 inline auto operator/(F1 f1, F2 f2)
 {
-	return [f1, f2](auto t) { return f1(t) / f2(t); };
+	return Binary<std::divides<>, F1, F2>(std::move(f1), std::move(f2));
 }
 
 // 没有和常数的直接加减，用 constant 来调用
@@ -73,25 +229,25 @@ inline auto operator/(F1 f1, F2 f2)
 template<typename F, std::enable_if_t<IsCallable<F>::value, int> = 0>
 inline auto operator*(F f, double c)
 {
-	return [f, c](auto t) { return f(t) * c; };
+	return std::move(f) * Constant(c);
 }
 
 template<typename F, std::enable_if_t<IsCallable<F>::value, int> = 0>
 inline auto operator/(F f, double c)
 {
-	return [f, c](auto t) { return f(t) / c; };
+	return std::move(f) / Constant(c);
 }
 
 template<typename F, std::enable_if_t<IsCallable<F>::value, int> = 0>
 inline auto operator*(double c, F f)
 {
-	return [f, c](auto t) { return c * f(t); };
+	return Constant(c) * std::move(f);
 }
 
 template<typename F, std::enable_if_t<IsCallable<F>::value, int> = 0>
 inline auto operator/(double c, F f)
 {
-	return [f, c](auto t) { return c / f(t); };
+	return Constant(c) / std::move(f);
 }
 } // namespace Operators
 
@@ -127,59 +283,299 @@ public:
 	Seconds end;
 };
 
+// 正弦 / 余弦
+// block 按相位递推：8 路交错，每路每次转过 8 个采样的相位，便于向量化；
+// 每 1024 个点重新精确计算一次起点，两次之间每路最多递推 1024 / 8 = 128 次；
+// 与逐点求值的差别约为逐点求值本身的舍入误差（约 1e-16·2πf·t）加上递推累积的误差
+// （最多约 128·4ε ≈ 1e-13）
+template<bool cosine>
+struct Wave : Signal<Wave<cosine>>
+{
+	Wave(double f, Seconds phase) : f(f), phase(phase) {}
+
+	double at(double seconds) const
+	{
+		auto x = 2 * Numbers::pi * f * (seconds + phase.count());
+		return cosine ? std::cos(x) : std::sin(x);
+	}
+
+	void block(Sampling sampling, std::size_t first, DataViews::DataView<double> out) const
+	{
+		constexpr std::size_t lanes = 8, reseed = 1024;
+		const double w = 2 * Numbers::pi * f;
+
+		// rc + i·rs = e^{ikδ}，cd + i·sd = e^{i·lanes·δ}，δ 为相邻采样的相位差
+		const double delta = w * sampling.dT, c1 = std::cos(delta), s1 = std::sin(delta);
+		double rc[lanes + 1] = {1.}, rs[lanes + 1] = {0.};
+		for(std::size_t k = 1; k <= lanes; ++k)
+		{
+			rc[k] = rc[k - 1] * c1 - rs[k - 1] * s1;
+			rs[k] = rs[k - 1] * c1 + rc[k - 1] * s1;
+		}
+		const double cd = rc[lanes], sd = rs[lanes];
+
+		for(std::size_t base = 0; base < out.size; base += reseed)
+		{
+			const auto count = std::min(reseed, out.size - base);
+			const auto x = w * (sampling.at(first + base) + phase).count();
+			const double c0 = std::cos(x), s0 = std::sin(x);
+			double c[lanes], s[lanes];
+			for(std::size_t k = 0; k != lanes; ++k)
+			{
+				c[k] = c0 * rc[k] - s0 * rs[k];
+				s[k] = s0 * rc[k] + c0 * rs[k];
+			}
+
+			auto dst = out.data + base;
+			std::size_t i = 0;
+			for(; i + lanes <= count; i += lanes)
+			{
+				for(std::size_t k = 0; k != lanes; ++k) dst[i + k] = cosine ? c[k] : s[k];
+				for(std::size_t k = 0; k != lanes; ++k)
+				{
+					double nc = c[k] * cd - s[k] * sd;
+					s[k] = s[k] * cd + c[k] * sd;
+					c[k] = nc;
+				}
+			}
+			for(std::size_t k = 0; i != count; ++i, ++k) dst[i] = cosine ? c[k] : s[k];
+		}
+	}
+
+	std::string describe() const
+	{
+		return Detail::format(cosine ? "cos(" : "sin(", f, "Hz", phase.count() != 0 ? Detail::format(", ", phase.count(), "s") : "", ')');
+	}
+
+	double f;
+	Seconds phase;
+};
+
+using Sin = Wave<false>;
+using Cos = Wave<true>;
+
 template<typename T = Seconds>
 inline auto sin(double f, T phase = {})
 {
-	return [=](auto t) {
-		auto seconds = (toSec(t) + phase).count();
-		return std::sin(2 * Numbers::pi * f * seconds);
-	};
+	return Sin(f, toSec(phase));
 }
 
 template<typename T = Seconds>
 inline auto cos(double f, T phase = {})
 {
-	return [=](auto t) {
-		auto seconds = (toSec(t) + phase).count();
-		return std::cos(2 * Numbers::pi * f * seconds);
-	};
+	return Cos(f, toSec(phase));
 }
 
 inline auto constant(double value)
 {
-	return [=](auto) { return value; };
+	return Constant(value);
 }
 
+// 只在 delay 时刻取 value，其余时刻为 0
+struct Delta : Signal<Delta>
+{
+	Delta(double value, Seconds delay) : value(value), delay(delay) {}
+
+	double at(double seconds) const { return seconds == delay.count() ? value : 0.; }
+
+	std::string describe() const { return Detail::format("delta(", value, ", ", delay.count(), "s)"); }
+
+	double value;
+	Seconds delay;
+};
+
 template<typename T = Seconds>
 inline auto delta(double value, T delay)
 {
-	return [=](auto t) { return t == delay ? value : 0.; };
+	return Delta(value, toSec(delay));
 }
 
-inline auto randomNoise()
+namespace Detail
 {
-	return [](auto) {
-		static RandomNumber machine(-1., 1.);
-		return machine();
-	};
+// 噪声的取值只由种子和采样时刻决定：没有共享状态，可以多线程并发求值，
+// 分段、并行生成与一次生成的结果逐点相同
+inline std::uint64_t counter(double seconds) noexcept
+{
+	std::uint64_t bits;
+	std::memcpy(&bits, &seconds, sizeof bits);
+	return bits;
+}
+
+inline std::uint64_t randomSeed()
+{
+	thread_local std::mt19937_64 seeds(std::random_device{}());
+	return seeds();
+}
+} // namespace Detail
+
+// [-1, 1) 上的均匀噪声
+struct RandomNoise : Signal<RandomNoise>
+{
+	explicit RandomNoise(std::uint64_t seed) : philox(seed) {}
+
+	double at(double seconds) const noexcept { return 2 * philox.uniform(Detail::counter(seconds))[0] - 1; }
+
+	std::string describe() const { return "noise"; }
+
+	Randoms::Philox philox;
+};
+
+struct GaussNoise : Signal<GaussNoise>
+{
+	GaussNoise(double value, double stddev, std::uint64_t seed) : value(value), stddev(stddev), philox(seed) {}
+
+	// Box-Muller，1 - u 落在 (0, 1]，避免 log(0)
+	double at(double seconds) const noexcept
+	{
+		auto [u1, u2] = philox.uniform(Detail::counter(seconds));
+		return value + stddev * std::sqrt(-2 * std::log(1 - u1)) * std::cos(2 * Numbers::pi * u2);
+	}
+
+	std::string describe() const { return Detail::format("gauss(", value, ", ", stddev, ')'); }
+
+	double value;
+	double stddev;
+	Randoms::Philox philox;
+};
+
+// 不指定种子时每次调用取一个新的随机种子，两个噪声之间互不相关
+inline auto randomNoise(std::uint64_t seed = Detail::randomSeed())
+{
+	return RandomNoise(seed);
 }
 
 inline auto gaussNoise(double value, double stddev = 1.0)
 {
-	return [=](auto) {
-		static GaussRandom machine(value, stddev);
-		return machine();
-	};
+	return GaussNoise(value, stddev, Detail::randomSeed());
+}
+
+inline auto gaussNoise(double value, double stddev, std::uint64_t seed)
+{
+	return GaussNoise(value, stddev, seed);
+}
+
+// 表达式树的文字形式，例如 ((sin(50Hz) * 2) + noise)
+template<typename G>
+inline std::string describe(const G& g)
+{
+	return Detail::describe(g);
+}
+
+// 一次求出整段信号，写入预先分配好的 out，out.size 决定点数
+template<typename G>
+inline void fill(Sampling sampling, const G& g, DataViews::DataView<double> out)
+{
+	Detail::block(g, sampling, 0, out);
 }
 
 template<template<typename...> typename Vec, typename G>
 inline auto generate(TimeRange r, double fs, G g)
 {
 	const auto count = std::size_t(std::floor(r.sec() * fs));
-	const double dT	 = 1 / fs;
-	Vec<double> vec;
-	vec.reserve(count);
-	for (std::size_t i = 0; i != count; ++i) vec.push_back(g(r.begin + Seconds(i * dT)));
+	Vec<double> vec(count);
+	fill(Sampling{r.begin, 1 / fs}, g, {vec.data(), count});
 	return vec;
 }
+
+// 按 Detail::slice 切分后交给 policy 并发求值，各段写入 out 中互不重叠的部分，
+// 结果与串行的 fill 逐点相同；g 会被多个线程同时调用，必须没有可变的共享状态
+template<typename Policy, typename G,
+		 std::enable_if_t<std::is_execution_policy_v<std::decay_t<Policy>>, int> = 0>
+inline void fill(Policy&& policy, Sampling sampling, const G& g, DataViews::DataView<double> out)
+{
+	std::vector<std::size_t> firsts;
+	for(std::size_t first = 0; first < out.size; first += Detail::slice) firsts.push_back(first);
+	std::for_each(std::forward<Policy>(policy), firsts.begin(), firsts.end(), [&](std::size_t first) {
+		auto count = std::min(Detail::slice, out.size - first);
+		Detail::block(g, sampling, first, {out.data + first, count});
+	});
+}
+
+template<template<typename...> typename Vec, typename Policy, typename G,
+		 std::enable_if_t<std::is_execution_policy_v<std::decay_t<Policy>>, int> = 0>
+inline auto generate(Policy&& policy, TimeRange r, double fs, G g)
+{
+	const auto count = std::size_t(std::floor(r.sec() * fs));
+	Vec<double> vec(count);
+	fill(std::forward<Policy>(policy), Sampling{r.begin, 1 / fs}, g, {vec.data(), count});
+	return vec;
+}
+
+// 按需逐块生成的信号源，内存占用只有一块，适合超长的仿真信号
+// next() 每次返回接下来至多 chunkSize 个点，结束后返回空视图；返回的视图在下一次 next() 前有效
+// 也可以用 next(out) 直接写入调用者的缓冲区（例如 FFT::buffer()）
+// chunkSize 为 1024 的整数倍时，结果与 generate 逐点相同
+template<typename G>
+class Stream
+{
+public:
+	Stream(TimeRange r, double fs, G g, std::size_t chunkSize = 16 * 1024) :
+		g(std::move(g)),
+		sampling{r.begin, 1 / fs},
+		count(std::size_t(std::floor(r.sec() * fs))),
+		buffer(std::max<std::size_t>(chunkSize, 1))
+	{}
+
+	std::size_t size() const noexcept { return count; }
+	std::size_t position() const noexcept { return pos; }
+	std::size_t chunkSize() const noexcept { return buffer.size(); }
+	bool done() const noexcept { return pos == count; }
+	void reset() noexcept { pos = 0; }
+
+	DataViews::DataView<const double> next()
+	{
+		auto n = next({buffer.data(), buffer.size()});
+		return {buffer.data(), n};
+	}
+
+	// 写入 out.size 与剩余点数中较小的个数，返回写入的点数
+	std::size_t next(DataViews::DataView<double> out)
+	{
+		auto n = std::min(out.size, count - pos);
+		Detail::block(g, sampling, pos, {out.data, n});
+		pos += n;
+		return n;
+	}
+
+	// for(auto chunk : stream) 从当前位置遍历到结束
+	struct End {};
+
+	class Iterator
+	{
+	public:
+		using value_type = DataViews::DataView<const double>;
+		using difference_type = std::ptrdiff_t;
+		using iterator_category = std::input_iterator_tag;
+
+		explicit Iterator(Stream& s) : s(&s), current(s.next()) {}
+
+		const value_type& operator*() const noexcept { return current; }
+		const value_type* operator->() const noexcept { return &current; }
+		Iterator& operator++() { current = s->next(); return *this; }
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const Iterator& i, End) noexcept { return i.current.size == 0; }
+		friend bool operator!=(const Iterator& i, End e) noexcept { return !(i == e); }
+
+	private:
+		Stream* s;
+		value_type current;
+	};
+
+	Iterator begin() { return Iterator(*this); }
+	End end() const noexcept { return {}; }
+
+private:
+	G g;
+	const Sampling sampling;
+	const std::size_t count;
+	std::size_t pos = 0;
+	std::vector<double> buffer;
+};
+
+template<typename G>
+inline auto stream(TimeRange r, double fs, G g, std::size_t chunkSize = 16 * 1024)
+{
+	return Stream<G>(r, fs, std::move(g), chunkSize);
+}
 } // namespace SignalSequence
@@ -0,0 +1,213 @@
+#pragma once
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+#include "DataView.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define UTILITY_SPECTRUM_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define UTILITY_SPECTRUM_TARGET(isa)
+#  else
+#    define UTILITY_SPECTRUM_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#endif
+
+// 频谱后处理：幅值、功率 (|c|²) 与分贝 (10·log10 |c|²)
+// 按运行时检测到的指令集选择 AVX-512 / AVX2 / 标量实现，结果与标量实现的误差在 1e-12 量级
+namespace Spectrums
+{
+using Complex = std::complex<double>;
+using In = DataViews::DataView<const Complex>;
+using Out = DataViews::DataView<double>;
+
+enum class Isa { Scalar, Avx2, Avx512 };
+
+namespace Detail
+{
+enum Op { Magnitude, Power, Decibel };
+
+template<typename T>
+inline T power(const std::complex<T>& c) noexcept { return c.real() * c.real() + c.imag() * c.imag(); }
+
+template<Op op, typename T>
+inline T finish(T p) noexcept
+{
+	if constexpr(op == Magnitude) return std::sqrt(p);
+	else if constexpr(op == Power) return p;
+	else return 10 * std::log10(p);
+}
+
+template<Op op, typename T>
+inline void scalar(const std::complex<T>* in, T* out, std::size_t n) noexcept
+{
+	for(std::size_t i = 0; i != n; ++i) out[i] = finish<op>(power(in[i]));
+}
+
+#if defined(UTILITY_SPECTRUM_X86)
+// 10·log10(p)：p = m·2^e，m 归一到 [√½, √2)，ln m 用 atanh 级数展开到 s^13，
+// 非正规数、0、inf、NaN 交给标量实现
+UTILITY_SPECTRUM_TARGET("avx2,fma")
+inline __m256d decibel(__m256d p) noexcept
+{
+	const __m256i bits = _mm256_castpd_si256(p);
+	const __m256i mantissa = _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL);
+	const __m256i one = _mm256_set1_epi64x(0x3FF0000000000000LL);
+	const __m256d magic = _mm256_set1_pd(4503599627370496. + 1023.); // 2^52 + bias
+
+	__m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, mantissa), one));
+	__m256i ebits = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.)));
+	__m256d e = _mm256_sub_pd(_mm256_castsi256_pd(ebits), magic);
+
+	__m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(1.4142135623730951), _CMP_GT_OQ);
+	m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+	e = _mm256_add_pd(e, _mm256_and_pd(big, _mm256_set1_pd(1.)));
+
+	__m256d s = _mm256_div_pd(_mm256_sub_pd(m, _mm256_set1_pd(1.)), _mm256_add_pd(m, _mm256_set1_pd(1.)));
+	__m256d s2 = _mm256_mul_pd(s, s);
+	__m256d r = _mm256_set1_pd(1. / 13);
+	for(double c : {1. / 11, 1. / 9, 1. / 7, 1. / 5, 1. / 3, 1.})
+		r = _mm256_fmadd_pd(r, s2, _mm256_set1_pd(c));
+	__m256d lnm = _mm256_mul_pd(_mm256_mul_pd(r, s), _mm256_set1_pd(2.));
+	__m256d ln = _mm256_fmadd_pd(e, _mm256_set1_pd(0.6931471805599453), lnm);
+	return _mm256_mul_pd(ln, _mm256_set1_pd(10 / 2.302585092994046));
+}
+
+template<Op op>
+UTILITY_SPECTRUM_TARGET("avx2,fma")
+inline void avx2(const Complex* in, double* out, std::size_t n) noexcept
+{
+	const double* d = reinterpret_cast<const double*>(in);
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4)
+	{
+		__m256d a = _mm256_loadu_pd(d + 2 * i);     // r0 i0 r1 i1
+		__m256d b = _mm256_loadu_pd(d + 2 * i + 4); // r2 i2 r3 i3
+		__m256d h = _mm256_hadd_pd(_mm256_mul_pd(a, a), _mm256_mul_pd(b, b)); // p0 p2 p1 p3
+		__m256d p = _mm256_permute4x64_pd(h, 0b11011000);
+
+		if constexpr(op == Magnitude)
+			_mm256_storeu_pd(out + i, _mm256_sqrt_pd(p));
+		else if constexpr(op == Power)
+			_mm256_storeu_pd(out + i, p);
+		else
+		{
+			_mm256_storeu_pd(out + i, decibel(p));
+			__m256d normal = _mm256_and_pd(
+				_mm256_cmp_pd(p, _mm256_set1_pd(std::numeric_limits<double>::min()), _CMP_GE_OQ),
+				_mm256_cmp_pd(p, _mm256_set1_pd(std::numeric_limits<double>::max()), _CMP_LE_OQ));
+			if(int mask = _mm256_movemask_pd(normal); mask != 0b1111)
+				for(int k = 0; k != 4; ++k)
+					if(!(mask & (1 << k))) out[i + k] = finish<Decibel>(power(in[i + k]));
+		}
+	}
+	scalar<op>(in + i, out + i, n - i);
+}
+
+template<Op op>
+UTILITY_SPECTRUM_TARGET("avx512f,avx2,fma")
+inline void avx512(const Complex* in, double* out, std::size_t n) noexcept
+{
+	// log 的向量实现只有 AVX2 版本
+	if constexpr(op == Decibel) return avx2<Decibel>(in, out, n);
+
+	const double* d = reinterpret_cast<const double*>(in);
+	const __m512i even = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+	const __m512i odd = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8)
+	{
+		__m512d a = _mm512_loadu_pd(d + 2 * i);
+		__m512d b = _mm512_loadu_pd(d + 2 * i + 8);
+		__m512d re = _mm512_permutex2var_pd(a, even, b);
+		__m512d im = _mm512_permutex2var_pd(a, odd, b);
+		__m512d p = _mm512_fmadd_pd(re, re, _mm512_mul_pd(im, im));
+
+		if constexpr(op == Magnitude)
+			_mm512_storeu_pd(out + i, _mm512_mask_sqrt_pd(p, 0xFF, p));
+		else
+			_mm512_storeu_pd(out + i, p);
+	}
+	avx2<op>(in + i, out + i, n - i);
+}
+
+inline Isa detect() noexcept
+{
+#  if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuidex(info, 7, 0);
+	const bool avx2 = info[1] & (1 << 5), avx512f = info[1] & (1 << 16);
+	__cpuid(info, 1);
+	const bool fma = info[2] & (1 << 12), osxsave = info[2] & (1 << 27);
+	if(!osxsave) return Isa::Scalar;
+	const auto xcr0 = _xgetbv(0);
+	if(avx512f && fma && (xcr0 & 0xE6) == 0xE6) return Isa::Avx512;
+	if(avx2 && fma && (xcr0 & 0x6) == 0x6) return Isa::Avx2;
+	return Isa::Scalar;
+#  else
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("fma")) return Isa::Avx512;
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::Avx2;
+	return Isa::Scalar;
+#  endif
+}
+#else
+inline Isa detect() noexcept { return Isa::Scalar; }
+#endif
+
+template<Op op, typename T>
+inline void run(DataViews::DataView<const std::complex<T>> in, DataViews::DataView<T> out, [[maybe_unused]] Isa isa)
+{
+	if(out.size < in.size) throw std::logic_error("Spectrums: output buffer is too small!");
+	if constexpr(std::is_same_v<T, double>)
+	{
+		switch(isa)
+		{
+#if defined(UTILITY_SPECTRUM_X86)
+		case Isa::Avx512: return avx512<op>(in.data, out.data, in.size);
+		case Isa::Avx2: return avx2<op>(in.data, out.data, in.size);
+#endif
+		default: break;
+		}
+	}
+	scalar<op>(in.data, out.data, in.size);
+}
+} // namespace Detail
+
+// 当前 CPU 支持的最高指令集，只检测一次
+inline Isa isa() noexcept
+{
+	static const Isa detected = Detail::detect();
+	return detected;
+}
+
+// 输出可以与输入不重叠的任意 double 缓冲区，out.size 至少为 in.size
+inline void magnitude(In in, Out out, Isa isa = Spectrums::isa()) { Detail::run<Detail::Magnitude>(in, out, isa); }
+inline void power(In in, Out out, Isa isa = Spectrums::isa()) { Detail::run<Detail::Power>(in, out, isa); }
+inline void decibel(In in, Out out, Isa isa = Spectrums::isa()) { Detail::run<Detail::Decibel>(in, out, isa); }
+
+// float / long double 没有手写的向量实现，交给编译器自动向量化
+template<typename T>
+inline void magnitude(DataViews::DataView<const std::complex<T>> in, DataViews::DataView<T> out, Isa isa = Spectrums::isa())
+{
+	Detail::run<Detail::Magnitude>(in, out, isa);
+}
+
+template<typename T>
+inline void power(DataViews::DataView<const std::complex<T>> in, DataViews::DataView<T> out, Isa isa = Spectrums::isa())
+{
+	Detail::run<Detail::Power>(in, out, isa);
+}
+
+template<typename T>
+inline void decibel(DataViews::DataView<const std::complex<T>> in, DataViews::DataView<T> out, Isa isa = Spectrums::isa())
+{
+	Detail::run<Detail::Decibel>(in, out, isa);
+}
+} // namespace Spectrums
+
+#undef UTILITY_SPECTRUM_TARGET
+#undef UTILITY_SPECTRUM_X86
@@ -0,0 +1,192 @@
+#include <vector>
+#include <cmath>
+#include "../include/Utility/FFT.h"
+#include "../include/Utility/STFT.h"
+#include "../include/Utility/Convolution.h"
+#include "../include/Utility/ComplexBuffer.h"
+#include "common.h"
+
+static bool near(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+int main()
+{
+    constexpr std::size_t N = 64, channels = 4;
+
+    std::vector<double> frame(N * channels);
+    for(std::size_t c = 0; c != channels; ++c)
+        for(std::size_t i = 0; i != N; ++i)
+            frame[c * N + i] = std::cos(2 * 3.141592653589793 * double(c + 1) * double(i) / N);
+
+    // batched transform agrees with one transform per channel
+    FFT batch(N, channels);
+    auto all = batch.calc(frame.data()).abs<std::vector>();
+    if(all.size() != batch.outSize() * channels) return 1;
+
+    FFT single(N);
+    for(std::size_t c = 0; c != channels; ++c)
+    {
+        auto one = single.calc(frame.data() + c * N).abs<std::vector>();
+        auto part = batch.abs<std::vector>(c);
+        for(std::size_t k = 0; k != one.size(); ++k)
+        {
+            if(!near(one[k], part[k])) return 2;
+            if(!near(one[k], all[c * batch.outSize() + k])) return 3;
+        }
+        if(!near(one[c + 1], N / 2.)) return 4;
+    }
+
+    // fill the aligned buffer in place and reuse the caller's output
+    auto in = batch.buffer(1);
+    std::copy(frame.begin() + N, frame.begin() + 2 * N, in.begin());
+    std::vector<double> bins(batch.outSize());
+    batch.calc().abs(1, bins);
+    for(std::size_t k = 0; k != bins.size(); ++k)
+        if(!near(bins[k], all[batch.outSize() + k])) return 8;
+
+    // measured plans are shared and survive a wisdom round trip
+    FFT measured(N, channels, 1, FFTRigor::Measure);
+    auto again = measured.calc(frame.data()).abs<std::vector>();
+    for(std::size_t k = 0; k != all.size(); ++k)
+        if(!near(again[k], all[k])) return 5;
+
+    auto wisdom = std::filesystem::temp_directory_path() / "utility-fft-wisdom";
+    if(!FFTPlans::saveWisdom(wisdom)) return 6;
+    if(!FFTPlans::loadWisdom(wisdom)) return 7;
+    std::filesystem::remove(wisdom);
+
+    // pushing a stream in odd sized pieces gives the same frames as one push
+    std::vector<double> stream(1000);
+    for(std::size_t i = 0; i != stream.size(); ++i) stream[i] = std::sin(0.3 * double(i));
+
+    STFT whole(N, 24, STFT::Hann), pieces(N, 24, STFT::Hann);
+    std::vector<std::vector<double>> expected;
+    auto frames = whole.push(stream, [&](const FFT& f) { expected.push_back(f.abs<std::vector>()); });
+    if(frames != 1 + (stream.size() - N) / 24) return 9;
+
+    std::size_t index = 0;
+    for(std::size_t begin = 0, step = 1; begin < stream.size(); begin += step, step = step * 3 % 37 + 1)
+    {
+        auto count = std::min(step, stream.size() - begin);
+        pieces.push({stream.data() + begin, count}, [&](const FFT& f) {
+            f.abs(bins);
+            for(std::size_t k = 0; k != bins.size(); ++k)
+                if(!near(bins[k], expected[index][k])) throw std::runtime_error("STFT frame mismatch");
+            ++index;
+        });
+    }
+    if(index != frames) return 10;
+
+    // r2c -> c2r and c2c round trips scale the signal by N
+    IFFT inverse(N);
+    single.calc(frame.data());
+    std::copy(single.output(), single.output() + single.outSize(), inverse.buffer().begin());
+    inverse.calc();
+    for(std::size_t i = 0; i != N; ++i)
+        if(!near(inverse.output()[i], N * frame[i])) return 11;
+
+    ComplexFFT forward(N);
+    ComplexIFFT backward(N);
+    for(std::size_t i = 0; i != N; ++i) forward.buffer().data[i] = {frame[i], frame[N + i]};
+    forward.calc();
+    if(!near(forward.abs<std::vector>()[1], N / 2.)) return 12;
+    backward.calc(forward.output());
+    for(std::size_t i = 0; i != N; ++i)
+        if(!near(backward.output()[i].real(), N * frame[i]) || !near(backward.output()[i].imag(), N * frame[N + i]))
+            return 13;
+
+    // vectorized spectrum kernels agree with the scalar ones
+    std::vector<double> fast(all.size()), slow(all.size());
+    using Kernel = void(*)(Spectrums::In, Spectrums::Out, Spectrums::Isa);
+    for(Kernel kernel : {Kernel(Spectrums::magnitude), Kernel(Spectrums::power), Kernel(Spectrums::decibel)})
+    {
+        kernel({batch.output(), all.size()}, fast, Spectrums::isa());
+        kernel({batch.output(), all.size()}, slow, Spectrums::Isa::Scalar);
+        for(std::size_t k = 0; k != fast.size(); ++k)
+            if(std::isfinite(slow[k]) ? std::abs(fast[k] - slow[k]) > 1e-9 * std::max(1., std::abs(slow[k])) : fast[k] != slow[k])
+                return 14;
+    }
+
+    // fast convolution and correlation match the direct sums
+    std::vector<double> h(37);
+    for(std::size_t i = 0; i != h.size(); ++i) h[i] = std::cos(0.7 * double(i)) / double(i + 1);
+    std::vector<double> direct(stream.size() + h.size() - 1, 0.), lags(direct.size(), 0.);
+    for(std::size_t n = 0; n != stream.size(); ++n)
+        for(std::size_t k = 0; k != h.size(); ++k)
+        {
+            direct[n + k] += stream[n] * h[k];
+            lags[n + h.size() - 1 - k] += stream[n] * h[k];
+        }
+    auto added = Convolutions::OverlapAdd(h).convolve(stream);
+    auto saved = Convolutions::OverlapSave(h).convolve(stream);
+    auto correlated = Convolutions::correlate(stream, h);
+    if(added.size() != direct.size() || saved.size() != direct.size() || correlated.size() != lags.size()) return 15;
+    for(std::size_t i = 0; i != direct.size(); ++i)
+        if(!near(added[i], direct[i]) || !near(saved[i], direct[i]) || !near(correlated[i], lags[i])) return 16;
+
+    // single and extended precision follow the double results
+    FFTf singlef(N);
+    FFTl singlel(N);
+    std::vector<float> framef(frame.begin(), frame.begin() + N);
+    std::vector<long double> framel(frame.begin(), frame.begin() + N);
+    auto onef = singlef.calc(framef.data()).abs<std::vector>();
+    auto onel = singlel.calc(framel.data()).abs<std::vector>();
+    for(std::size_t k = 0; k != onef.size(); ++k)
+        if(std::abs(onef[k] - all[k]) > 1e-4 || !near(double(onel[k]), all[k])) return 17;
+
+    // split complex kernels work on the FFT output in place and on SoA buffers
+    FFT spectrum(N);
+    spectrum.calc(frame.data());
+    auto view = Complexs::interleaved(spectrum.output(), spectrum.outSize());
+    Complexs::ComplexBuffer soa(view), product(view.size);
+    std::vector<double> magnitude(view.size), fromView(view.size);
+    Complexs::mul(soa, view, product);
+    Complexs::conj(product, product);
+    Complexs::abs(soa, magnitude);
+    Complexs::abs(view, fromView);
+    for(std::size_t k = 0; k != view.size; ++k)
+    {
+        auto expected = std::conj(spectrum.output()[k] * spectrum.output()[k]);
+        if(!near(product[k].real, expected.real()) || !near(product[k].imag(), expected.imag())) return 18;
+        if(!near(magnitude[k], std::abs(spectrum.output()[k])) || !near(fromView[k], magnitude[k])) return 19;
+    }
+
+    // a moved-from buffer is empty and can still be copied and reassigned
+    Complexs::ComplexBuffer moved(std::move(soa)), copied(soa);
+    if(soa.size() != 0 || copied.size() != 0 || moved.size() != view.size || !near(moved[1].real, spectrum.output()[1].real())) return 25;
+    soa = std::move(moved);
+    if(moved.size() != 0 || soa.size() != view.size) return 25;
+
+    // batch polar conversion: exact matches PolarComplex, fast stays inside its documented bounds
+    std::vector<Complexs::Complex> points, back;
+    for(int i = -500; i <= 500; ++i) points.emplace_back(std::cos(0.37 * i) * (i % 7), std::sin(1.3 * i) * 2);
+    back = points;
+    std::vector<Complexs::PolarComplex> exact(points.size(), {0, 0}), approximate(exact);
+    Complexs::toPolar(points, exact);
+    Complexs::toPolar(points, approximate, Complexs::Accuracy::Fast);
+    Complexs::toComplex(exact, back, Complexs::Accuracy::Fast);
+    for(std::size_t i = 0; i != points.size(); ++i)
+    {
+        Complexs::PolarComplex reference(points[i]);
+        if(exact[i].r != reference.r || exact[i].theta != reference.theta) return 20;
+        if(approximate[i].r != reference.r || std::abs(approximate[i].theta - reference.theta) > 5e-8) return 21;
+        if((back[i] - points[i]).abs() > 1e-11 * std::max(1., points[i].abs())) return 22;
+    }
+
+    // the fast sin/cos keeps its bound for large angles up to |θ| < 1e6, and falls back to std beyond
+    std::vector<Complexs::PolarComplex> wide;
+    for(int i = 0; i != 4000; ++i) wide.emplace_back(1., (i % 2 ? -1 : 1) * 249.9937 * i);
+    for(double huge : {1e6, -3e9, 1e300}) wide.emplace_back(1., huge);
+    std::vector<Complexs::Complex> unit(wide.size(), {0, 0});
+    Complexs::toComplex(wide, unit, Complexs::Accuracy::Fast);
+    for(std::size_t i = 0; i != wide.size(); ++i)
+        if(std::abs(unit[i].real - std::cos(wide[i].theta)) > 1e-12 || std::abs(unit[i].imag() - std::sin(wide[i].theta)) > 1e-12) return 23;
+
+    // a failed plan throws and releases the buffers allocated before it
+    try
+    {
+        FFT empty(0);
+        return 24;
+    }
+    catch(const std::runtime_error&) {}
+    return 0;
+}
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../include/Utility/LinkedMap.h"
+#include "../include/Utility/FlatLinkMap.h"
+#include "../include/Utility/ConcurrentLinkMap.h"
+#include "../include/Utility/LruCache.h"
+#include "common.h"
+
+// insertion order and key order against a vector + std::map reference
+template<typename M>
+static bool sameAs(M& m, const std::vector<std::pair<std::string, int>>& order)
+{
+    if(m.size() != order.size()) return false;
+    std::size_t i = 0;
+    for(auto&& [k, v] : m.list())
+        if(k != order[i].first || v != order[i++].second) return false;
+    std::map<std::string, int> sorted(order.begin(), order.end());
+    auto pos = sorted.begin();
+    for(auto&& [k, v] : m.map())
+        if(k != pos->first || v != (pos++)->second) return false;
+    for(std::size_t j = 0; j != order.size(); ++j)
+        if(m.indexOf(order[j].first) != j || m.at(order[j].first) != order[j].second) return false;
+    return true;
+}
+
+// positional access, removals, reordering and copies against a vector reference
+template<typename M>
+static int positional(unsigned& state)
+{
+    M linked;
+    std::vector<std::pair<std::string, int>> order;
+    for(int step = 0; step != 20000; ++step)
+    {
+        state = state * 1103515245 + 12345;
+        auto key = std::to_string(state % 512);
+        if(state % 3 == 0)
+        {
+            auto pos = std::find_if(order.begin(), order.end(), [&](auto& p) { return p.first == key; });
+            if(pos != order.end())
+            {
+                linked.eraseAt(std::size_t(pos - order.begin()));
+                order.erase(pos);
+            }
+        }
+        else if(state % 7 == 0)
+        {
+            auto at = std::size_t(state >> 16) % (order.size() + 1);
+            if(linked.emplaceAt(at, key, step).second)
+                order.emplace(order.begin() + at, key, step);
+        }
+        else if(linked.emplace(key, step).second)
+            order.emplace_back(key, step);
+        if(step % 1000 == 0 && !sameAs(linked, order)) return 8;
+    }
+    if(!sameAs(linked, order)) return 9;
+    for(std::size_t i = 0; i != order.size(); ++i)
+    {
+        auto iter = linked.listAt(i);
+        if(iter.key() != order[i].first || iter.index() != i) return 10;
+        if(linked.list()[int(i)].first != order[i].first) return 11;
+    }
+    const auto& constLinked = linked;
+    if(constLinked.listAt(order.size() - 1).key() != order.back().first) return 12;
+    M copied = constLinked;
+    if(!sameAs(copied, order)) return 12;
+    linked.clear();
+    linked.emplace("x", 1);
+    if(linked.listAt(0).value() != 1 || linked.indexOf("x") != 0) return 13;
+
+    // moveBack keeps positions correct
+    order.clear();
+    linked.clear();
+    for(int i = 0; i != 300; ++i)
+    {
+        linked.emplace(std::to_string(i), i);
+        order.emplace_back(std::to_string(i), i);
+    }
+    for(int step = 0; step != 3000; ++step)
+    {
+        state = state * 1103515245 + 12345;
+        auto pick = std::size_t(state >> 8) % order.size();
+        linked.moveBack(linked.listAt(pick));
+        std::rotate(order.begin() + std::ptrdiff_t(pick), order.begin() + std::ptrdiff_t(pick) + 1, order.end());
+        if(linked.listAt(pick).key() != order[pick].first || linked.indexOf(order.back().first) != order.size() - 1) return 36;
+    }
+    if(!sameAs(linked, order)) return 37;
+    return 0;
+}
+
+int main()
+{
+    // the flat variant keeps both orders through inserts, erases and compaction
+    FlatLinkMap<std::string, int> flat{{"b", 1}, {"a", 2}, {"c", 3}};
+    std::vector<std::pair<std::string, int>> order{{"b", 1}, {"a", 2}, {"c", 3}};
+    if(!sameAs(flat, order)) return 1;
+    if(flat.insert("a", 9).second || flat.at("a") != 2) return 2;
+    std::string_view viewKey = "c";
+    const char* cKey = "b";
+    if(!flat.contains(viewKey) || flat.at(viewKey) != 3 || *flat.tryGet(cKey) != 1 || flat.indexOf(viewKey) != 2) return 42;
+
+    unsigned state = 7;
+    for(int step = 0; step != 20000; ++step)
+    {
+        state = state * 1103515245 + 12345;
+        auto key = std::to_string(state % 512);
+        if(state % 3 == 0)
+        {
+            bool erased = flat.erase(key);
+            auto pos = std::find_if(order.begin(), order.end(), [&](auto& p) { return p.first == key; });
+            if(erased != (pos != order.end())) return 3;
+            if(erased) order.erase(pos);
+        }
+        else if(flat.emplace(key, step).second)
+            order.emplace_back(key, step);
+        if(step % 1000 == 0 && !sameAs(flat, order)) return 4;
+    }
+    if(!sameAs(flat, order) || flat.contains("nope") || flat.tryGet("nope")) return 5;
+    const auto& constFlat = flat;
+    if(constFlat.list().key() != order.front().first) return 6;
+    flat.clear();
+    if(flat.size() != 0 || flat.list() != flat.list().end() || flat.contains(order.front().first)) return 7;
+    flat.insert("z", 1);
+    flat.insert("y", 2);
+    auto keyOrder = flat.map();
+    if(std::distance(keyOrder.begin(), keyOrder.end()) != 2 || keyOrder.begin()->first != "y") return 33;
+
+    // positional access through the index, and by walking the list when there is none
+    if(auto code = positional<IndexedLinkMap<std::string, int>>(state)) return code;
+    if(auto code = positional<LinkMap<std::string, int>>(state)) return code;
+
+    // inserting into the middle and querying positions in turn stays O(log n) per step
+    IndexedLinkMap<std::uint64_t, std::uint64_t> middle;
+    for(std::uint64_t i = 0; i != 200000; ++i)
+    {
+        const auto at = std::size_t(middle.size() / 2);
+        middle.emplaceAt(at, i, i);
+        if(middle.listAt(at).key() != i || middle.indexOf(i) != at) return 34;
+    }
+    for(int i = 0; i != 100000; ++i)
+    {
+        const auto at = std::size_t(middle.size() / 3);
+        const auto key = middle.listAt(at).key();
+        middle.eraseAt(at);
+        if(middle.contains(key) || middle.listAt(at).index() != at) return 35;
+    }
+    std::size_t walked = 0;
+    for(auto iter = middle.list(); iter; ++iter)
+        if(iter.index() != walked++) return 35;
+
+    // arena-backed maps: rebuilding after an O(1) clear and a pmr pool
+    LinkMapArena arena;
+    ArenaLinkMap<std::uint64_t, std::uint64_t> pooled(arena);
+    for(std::uint64_t round = 0; round != 3; ++round)
+    {
+        pooled.clear();
+        arena.release();
+        for(std::uint64_t i = 0; i != 1000; ++i) pooled.emplace(i * 7919 % 1000, i + round);
+        if(pooled.size() != 1000 || pooled.list().key() != 0 || pooled.listAt(1).key() != 919) return 14;
+        if(pooled.map()->first != 0 || pooled.at(919) != 1 + round) return 15;
+    }
+    std::pmr::unsynchronized_pool_resource pool;
+    PmrLinkMap<std::string, int> pmr{std::pmr::polymorphic_allocator<std::pair<const std::string, int>>(&pool)};
+    order.clear();
+    for(int i = 0; i != 100; ++i)
+    {
+        pmr.emplace(std::to_string(i * 37 % 101), i);
+        order.emplace_back(std::to_string(i * 37 % 101), i);
+    }
+    if(!sameAs(pmr, order) || pmr.get_allocator().resource() != &pool) return 16;
+
+    // move keeps the nodes and relinks the sentinel, copy keeps the insertion order
+    auto source = [] {
+        std::vector<std::pair<std::string, int>> items{{"m", 1}, {"c", 2}, {"x", 3}, {"c", 4}, {"a", 5}};
+        return LinkMap<std::string, int>(items.begin(), items.end());
+    };
+    order = {{"m", 1}, {"c", 2}, {"x", 3}, {"a", 5}};
+    auto moved = source();
+    if(!sameAs(moved, order)) return 17;
+    moved.eraseAt(0);
+    auto copied = moved;
+    order.erase(order.begin());
+    if(!sameAs(copied, order) || !sameAs(moved, order)) return 18;
+    copied.emplace("b", 6);
+    if(moved.contains("b") || copied.listAt(3).key() != "b") return 19;
+    std::vector<LinkMap<std::string, int>> stored;
+    stored.push_back(std::move(moved));
+    stored.push_back(source());
+    if(!sameAs(stored[0], order) || moved.size() != 0 || moved.list() != moved.list().end()) return 20;
+    moved = stored[1];
+    stored[0] = std::move(stored[1]);
+    if(stored[1].size() != 0 || moved.indexOf("x") != 2 || stored[0].indexOf("a") != 3) return 21;
+    const auto& constMoved = moved;
+    std::string keys;
+    for(auto iter = constMoved.map(); iter; ++iter) keys += iter->first;
+    if(keys != "acmx") return 22;
+
+    // copies between maps on different pmr resources move element by element
+    std::pmr::unsynchronized_pool_resource other;
+    PmrLinkMap<std::string, int> target{std::pmr::polymorphic_allocator<std::pair<const std::string, int>>(&other)};
+    target = std::move(pmr);
+    if(target.get_allocator().resource() != &other || target.size() != 100 || pmr.size() != 0) return 23;
+
+    // readers walk consistent snapshots while a writer keeps a sliding window of keys
+    ConcurrentLinkMap<std::uint64_t, std::uint64_t> shared;
+    std::atomic<bool> done = false, torn = false;
+    std::vector<std::thread> readers;
+    for(int r = 0; r != 4; ++r)
+        readers.emplace_back([&] {
+            while(!done)
+            {
+                auto snap = shared.snapshot();
+                std::uint64_t last = 0, count = 0;
+                for(auto iter = snap->list(); iter; ++iter)
+                {
+                    if((count != 0 && iter.key() != last + 1) || iter.value() != iter.key() * 2) torn = true;
+                    if(iter.index() != count++) torn = true;
+                    last = iter.key();
+                }
+                if(count != snap->size() || (count != 0 && count > 64)) torn = true;
+                // lookups through the cached per-thread snapshot see whole versions too
+                auto value = shared.get(last);
+                if(shared.size() > 64 || (value && *value != last * 2)) torn = true;
+            }
+        });
+    for(std::uint64_t i = 0; i != 3000; ++i)
+    {
+        shared.update([&](auto& m) {
+            m.emplace(i, i * 2);
+            if(i >= 64) m.eraseAt(0);
+        });
+    }
+    done = true;
+    for(auto& t : readers) t.join();
+    if(torn || shared.size() != 64 || shared.get(2999) != 5998u || shared.get(0) || shared.contains(2935)) return 24;
+    if(!shared.erase(2999) || shared.erase(2999) || !shared.emplace(std::uint64_t(1), std::uint64_t(2))) return 25;
+    auto updated = shared.update([](auto& m) -> std::uint64_t& { return m.at(std::uint64_t(1)) = 7; });
+    static_assert(std::is_same_v<decltype(updated), std::uint64_t>);
+    if(updated != 7 || shared.get(std::uint64_t(1)) != 7u) return 25;
+    shared.clear();
+    if(shared.size() != 0 || shared.snapshot()->list()) return 26;
+
+    // LRU: touch on get, eviction by count and by weight, heterogeneous lookup
+    std::vector<std::string> evicted;
+    LruCache<std::string, std::string> lru(3, 12,
+        [](const std::string&, const std::string& v) { return v.size(); },
+        [&](const std::string& k, std::string&) { evicted.push_back(k); });
+    lru.put("a", "1");
+    lru.put("b", "22");
+    lru.put("c", "333");
+    if(!lru.get(std::string_view("a")) || lru.get("zz") || lru.hits() != 1 || lru.misses() != 1) return 27;
+    lru.put("d", "4444"); // over capacity, "b" is the least recently used
+    if(evicted != std::vector<std::string>{"b"} || lru.contains("b") || lru.weight() != 8) return 28;
+    lru.put("c", "555555555"); // replacing "c" brings the total to 14 bytes, over the budget
+    if(evicted != std::vector<std::string>{"b", "a", "d"} || lru.size() != 1 || *lru.peek("c") != "555555555") return 29;
+    // an entry over the whole budget is rejected and leaves the others alone
+    if(lru.put("big", "0123456789abc") || lru.size() != 1 || !lru.contains("c") || lru.contains("big") || lru.evictions() != 3) return 30;
+    for(int i = 0; i != 3; ++i) lru.put(std::to_string(i), "x");
+    lru.get("0");
+    std::string recency;
+    lru.forEach([&](const std::string& k, const std::string&) { recency += k; });
+    if(recency != "120" || !lru.erase("2") || lru.erase("2") || lru.evictions() != 4) return 31;
+    lru.resize(1);
+    if(lru.size() != 1 || !lru.contains("0") || lru.weight() != 1) return 32;
+    lru.resize(3, 12);
+    lru.put("1", "y");
+    if(lru.put("0", "0123456789abc") || lru.contains("0") || !lru.contains("1") || lru.weight() != 1) return 43;
+
+    // long churn: gets, puts and erases over a small key space stay consistent
+    LruCache<std::uint64_t, std::uint64_t> churn(64, 64 * 8,
+        [](const std::uint64_t&, const std::uint64_t&) { return std::size_t(8); });
+    std::uint64_t hitsSeen = 0, missesSeen = 0;
+    for(std::uint64_t i = 0; i != 1000000; ++i)
+    {
+        state = state * 1103515245 + 12345;
+        const std::uint64_t key = (state >> 8) % 256;
+        switch(state % 4)
+        {
+        case 0: churn.erase(key); break;
+        case 1: churn.put(key, key * 3); break;
+        default:
+            if(auto v = churn.get(key)) { ++hitsSeen; if(*v != key * 3) return 38; }
+            else ++missesSeen;
+        }
+        if(churn.size() > 64 || churn.weight() != churn.size() * 8) return 39;
+    }
+    if(churn.hits() != hitsSeen || churn.misses() != missesSeen || churn.evictions() == 0) return 40;
+    std::uint64_t newest = 0;
+    churn.forEach([&](const std::uint64_t& k, const std::uint64_t&) { newest = k; });
+    if(churn.get(newest) == nullptr) return 41;
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../include/Utility/ComplexBuffer.h"
+
+using namespace Complexs;
+
+// points/sec of the batch polar conversions, per-element PolarComplex as the baseline,
+// plus the largest deviation of the fast mode from the exact one
+template<typename F>
+static double pointsPerSec(std::size_t points, F&& f)
+{
+    using namespace std::chrono;
+    std::size_t rounds = 0;
+    auto begin = steady_clock::now();
+    auto end = begin;
+    do { f(); ++rounds; end = steady_clock::now(); } while(end - begin < 300ms);
+    return double(points * rounds) / duration<double>(end - begin).count();
+}
+
+int main()
+{
+    for(std::size_t points : {4096, 1048576})
+    {
+        std::vector<Complex> in, back(points, Complex(0));
+        std::vector<PolarComplex> polar(points, PolarComplex(0, 0)), exact(polar);
+        for(std::size_t i = 0; i != points; ++i)
+            in.emplace_back(std::cos(0.37 * double(i)) * double(i % 13 + 1), std::sin(0.91 * double(i)) * 3);
+
+        std::printf("%8zu points, PolarComplex(c) %.3e, exact %.3e, fast %.3e points/s\n", points,
+                    pointsPerSec(points, [&] { for(std::size_t i = 0; i != points; ++i) polar[i] = PolarComplex(in[i]); }),
+                    pointsPerSec(points, [&] { toPolar(in, polar); }),
+                    pointsPerSec(points, [&] { toPolar(in, polar, Accuracy::Fast); }));
+        std::printf("%8zu points, Complex(p)      %.3e, exact %.3e, fast %.3e points/s\n", points,
+                    pointsPerSec(points, [&] { for(std::size_t i = 0; i != points; ++i) back[i] = Complex(polar[i]); }),
+                    pointsPerSec(points, [&] { toComplex(polar, back); }),
+                    pointsPerSec(points, [&] { toComplex(polar, back, Accuracy::Fast); }));
+
+        toPolar(in, exact);
+        toPolar(in, polar, Accuracy::Fast);
+        double theta = 0, cartesian = 0;
+        for(std::size_t i = 0; i != points; ++i) theta = std::max(theta, std::abs(polar[i].theta - exact[i].theta));
+        toComplex(exact, back, Accuracy::Fast);
+        for(std::size_t i = 0; i != points; ++i)
+            cartesian = std::max(cartesian, (back[i] - in[i]).abs() / std::max(1., in[i].abs()));
+        std::printf("%8zu points, fast max error: theta %.2e rad, cartesian %.2e\n", points, theta, cartesian);
+    }
+}
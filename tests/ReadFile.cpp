@@ -0,0 +1,96 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../include/Utility/ReadFile.h"
+#include "common.h"
+
+using namespace ReadFiles;
+
+int main()
+{
+    const auto dir = fs::temp_directory_path();
+    const auto text = dir / "utility-readfile.txt", empty = dir / "utility-readfile-empty.txt";
+    const std::string content = "first line\r\nsecond\n\nlast without newline";
+    std::ofstream(text, std::ios::binary) << content;
+    std::ofstream(empty, std::ios::binary);
+
+    // the mapping shows the same bytes as readFile
+    {
+        auto mapped = mmapFile(text);
+        auto bytes = readFile(text);
+        auto view = mapped.view();
+        if(std::string(view.begin(), view.end()) != content) return 1;
+        if(std::string(bytes.begin(), bytes.end()) != content) return 2;
+        mapped.advise(Access::Random);
+
+        auto moved = std::move(mapped);
+        if(moved.view().size != content.size() || mapped.view().size != 0) return 3;
+        if(mmapFile(empty).view().size != 0) return 4;
+    }
+
+    // line ranges over a chunked read and over the mapping agree with getline, minus the '\r'
+    {
+        const std::vector<std::string_view> expected{"first line", "second", "", "last without newline"};
+        std::vector<std::string> chunked;
+        for(auto line : lines(text, 4)) chunked.emplace_back(line);
+        if(chunked != std::vector<std::string>(expected.begin(), expected.end())) return 5;
+
+        auto mapped = mmapFile(text);
+        std::vector<std::string_view> viewed;
+        for(auto line : lines(mapped)) viewed.push_back(line);
+        if(viewed != expected) return 6;
+
+        std::size_t count = 0;
+        for([[maybe_unused]] auto line : lines(empty)) ++count;
+        if(count != 0) return 7;
+    }
+
+    // batch loading, with the failure of one file kept to its own future / callback
+    {
+        std::vector<fs::path> files{text, dir / "utility-readfile-missing.txt", empty, text};
+        BatchRead batch(files, 3);
+        auto first = batch.get(0);
+        if(std::string(first.begin(), first.end()) != content) return 8;
+        try { batch.get(1); return 9; } catch(const std::runtime_error&) {}
+        if(!batch.get(2).empty() || batch.get(3) != first) return 10;
+
+        std::atomic<std::size_t> bytes = 0, errors = 0;
+        readFiles(files, [&](std::size_t, std::vector<char> data, std::exception_ptr error) {
+            bytes += data.size();
+            errors += error != nullptr;
+        });
+        if(bytes != 2 * content.size() || errors != 1) return 11;
+
+        // an exception from the callback is rethrown by readFiles once every thread has ended
+        try
+        {
+            readFiles(files, [](std::size_t i, std::vector<char>, std::exception_ptr) {
+                if(i == 2) throw std::logic_error("stop");
+            }, 2);
+            return 17;
+        }
+        catch(const std::logic_error&) {}
+    }
+
+    // one-pass text loading trims '\0' padding across chunk borders and validates UTF-8
+    {
+        const auto padded = dir / "utility-readfile-padded.txt";
+        const std::string utf8 = "h\xC3\xA9llo \xE4\xB8\x96\xE7\x95\x8C \xF0\x9F\x98\x80" + std::string(1, '\0') + "end";
+        std::ofstream(padded, std::ios::binary) << std::string(11, '\0') << utf8 << std::string(5, '\0');
+        if(readUtf8(padded, 3) != utf8 || readUtf8(padded) != readText(padded)) return 12;
+
+        std::ofstream(padded, std::ios::binary) << std::string(2, '\0') << "ok \xE4\xB8" << std::string(3, '\0');
+        try { readUtf8(padded, 2); return 13; }
+        catch(const Utf8Error& e) { if(e.offset() != 3) return 14; }
+
+        if(validateUtf8("\xED\xA0\x80") != 0 || validateUtf8("a\xC0\xAF") != 1 || validateUtf8("\xF4\x90\x80\x80") != 0) return 15;
+        if(validateUtf8(utf8) != std::string_view::npos || validateUtf8("abc\xF0\x9F\x98") != 3) return 16;
+        fs::remove(padded);
+    }
+
+    fs::remove(text);
+    fs::remove(empty);
+    return 0;
+}
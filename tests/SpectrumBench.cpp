@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <execution>
+#include <vector>
+#include "../include/Utility/Spectrum.h"
+
+using namespace Spectrums;
+
+// bins/sec of the post-processing kernels against the former
+// std::transform(par_unseq, std::abs) path of FFT::abs()
+template<typename F>
+static double binsPerSec(std::size_t bins, F&& f)
+{
+    using namespace std::chrono;
+    std::size_t rounds = 0;
+    auto begin = steady_clock::now();
+    auto end = begin;
+    do { f(); ++rounds; end = steady_clock::now(); } while(end - begin < 300ms);
+    return double(bins * rounds) / duration<double>(end - begin).count();
+}
+
+int main()
+{
+    const char* names[] = {"scalar", "avx2", "avx512"};
+    std::printf("detected: %s\n", names[int(isa())]);
+
+    for(std::size_t bins : {257, 4097, 65537, 1048577})
+    {
+        std::vector<Complex> in(bins);
+        for(std::size_t i = 0; i != bins; ++i) in[i] = {double(i % 97) - 48, double(i % 31) + 0.5};
+        std::vector<double> out(bins);
+
+        std::printf("%8zu bins, std::abs par_unseq: %.3e bins/s\n", bins, binsPerSec(bins, [&] {
+            std::transform(std::execution::par_unseq, in.begin(), in.end(), out.begin(),
+                           [](const auto& c) noexcept { return std::abs(c); });
+        }));
+        for(auto level : {Isa::Scalar, Isa::Avx2, Isa::Avx512})
+        {
+            if(level > isa()) break;
+            std::printf("%8zu bins, %-6s magnitude %.3e, power %.3e, decibel %.3e bins/s\n", bins, names[int(level)],
+                        binsPerSec(bins, [&] { magnitude(in, out, level); }),
+                        binsPerSec(bins, [&] { power(in, out, level); }),
+                        binsPerSec(bins, [&] { decibel(in, out, level); }));
+        }
+    }
+}